@@ -57,6 +57,14 @@ namespace tsg {
     ///The destructor does actually nothing.
     ~BaseTS();
 
+    ///\brief Seeds the random engine.
+    ///
+    ///\param [in] seed_in Hands over the seed.
+    ///
+    ///This function seeds the random engine, i.e., the generated time series
+    ///are reproducible.
+    void seed(const unsigned int seed_in);
+
     ///\brief The simple random walk method.
     ///
     ///\param [out] &timeSeries_out Hands over the random synthetic time
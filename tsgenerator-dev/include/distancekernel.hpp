@@ -0,0 +1,86 @@
+///\file distancekernel.hpp
+///
+///\brief File contains the z-normalized Euclidean distance kernel.
+///
+///This is the header file of the vectorized distance kernel shared by the
+///similarity functions of the generator, the top set motif object and the
+///utilities.
+
+#ifndef DISTANCEKERNEL_HPP
+#define DISTANCEKERNEL_HPP
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <tsgtypes.hpp>
+
+
+namespace tsg {
+
+  ///\brief Calls a function with the window size as a compile-time constant.
+  ///
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] &&function_in Hands over the function, which takes a
+  ///std::integral_constant of the window size.
+  ///
+  ///\return The result of the function.
+  ///
+  ///The benchmarks use a handful of window sizes. For these the function is
+  ///called with the window size as a compile-time constant, such that the
+  ///kernels are unrolled and vectorized without tails. All other window
+  ///sizes call the function with 0, i.e., the generic kernel reading the
+  ///window size at runtime.
+  template <typename Function>
+  auto dispatchWindow(const int window_in, Function &&function_in) {
+
+    switch (window_in) {
+
+      case 30:
+        return function_in(std::integral_constant<int, 30>());
+      case 40:
+        return function_in(std::integral_constant<int, 40>());
+      case 100:
+        return function_in(std::integral_constant<int, 100>());
+      case 150:
+        return function_in(std::integral_constant<int, 150>());
+      default:
+        return function_in(std::integral_constant<int, 0>());
+    }
+  }
+
+  ///\brief The number of values between two early abandoning checks.
+  ///
+  ///The distance kernel accumulates the squared differences in eight lanes
+  ///and checks the best similarity so far after each block of
+  ///distanceKernelBlock values.
+  const int distanceKernelBlock = 32;
+
+  ///\brief Computes the distance of two z-normalized subsequences.
+  ///
+  ///\param [in] *x0_in Hands over the values of the first subsequence.
+  ///\param [in] *x1_in Hands over the values of the second subsequence.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] mean0_in Hands over the mean of the first subsequence.
+  ///\param [in] rSigma0_in Hands over the inverse standard deviation of the
+  ///first subsequence.
+  ///\param [in] mean1_in Hands over the mean of the second subsequence.
+  ///\param [in] rSigma1_in Hands over the inverse standard deviation of the
+  ///second subsequence.
+  ///\param [in] bestSoFar_in Hands over the best similarity so far.
+  ///
+  ///\return The distance of the two z-normalized subsequences if it is
+  ///smaller than the best similarity so far and a value not smaller than the
+  ///best similarity so far otherwise.
+  ///
+  ///This function chooses the widest SIMD kernel supported by the processor
+  ///at runtime and falls back to the scalar kernel otherwise. All kernels
+  ///sum in the same lanes and order, i.e., they return identical results.
+  ///The window sizes of dispatchWindow use specialized kernels.
+  double zNormDistance(const double *x0_in, const double *x1_in, const int
+      window_in, const double mean0_in, const double rSigma0_in, const double
+      mean1_in, const double rSigma1_in, const double bestSoFar_in
+      = std::numeric_limits<double>::max());
+}
+
+#endif
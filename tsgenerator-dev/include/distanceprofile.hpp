@@ -0,0 +1,312 @@
+///\file distanceprofile.hpp
+///
+///\brief File contains the DistanceProfile class declaration.
+///
+///This is the header file of the DistanceProfile. The DistanceProfile computes
+///the z-normalized Euclidean distances of one query to all subsequences of a
+///time series with the fast Fourier transform, i.e., in O(n log n) instead of
+///O(n * window) like MASS.
+
+#ifndef DISTANCEPROFILE_HPP
+#define DISTANCEPROFILE_HPP
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <complex>
+#include <vector>
+#include <tsgtypes.hpp>
+#include <subsequencestats.hpp>
+
+
+namespace tsg {
+
+  ///\brief Computes the twiddle factors of the fast Fourier transform.
+  ///
+  ///\param [in] size_in Hands over the size of the transform.
+  ///\param [out] &twiddles_out Returns the twiddle factors.
+  ///
+  ///This function computes the first size_in / 2 roots of unity
+  ///exp(-2 pi i k / size_in). Each factor is computed directly, i.e., the
+  ///factors do not accumulate rounding errors.
+  void fftTwiddles(const int size_in, cseq &twiddles_out);
+
+  ///\brief The fast Fourier transform with precomputed twiddle factors.
+  ///
+  ///\param [in,out] &data_inout Hands over the sequence and returns its
+  ///transform.
+  ///\param [in] &twiddles_in Hands over the twiddle factors of the size of the
+  ///sequence.
+  ///\param [in] inverse_in Hands over a flag whether to compute the inverse
+  ///transform or not.
+  ///
+  ///This is an iterative in-place radix-2 fast Fourier transform. The size of
+  ///the sequence has to be a power of two. The inverse transform is scaled by
+  ///the reciprocal of the size.
+  void fft(cseq &data_inout, const cseq &twiddles_in, const bool inverse_in
+      = false);
+
+  ///\brief The fast Fourier transform.
+  ///
+  ///\param [in,out] &data_inout Hands over the sequence and returns its
+  ///transform.
+  ///\param [in] inverse_in Hands over a flag whether to compute the inverse
+  ///transform or not.
+  ///
+  ///This function computes the twiddle factors and transforms the sequence.
+  ///The size of the sequence has to be a power of two.
+  void fft(cseq &data_inout, const bool inverse_in = false);
+
+  ///\brief Checks whether distance profiles pay off.
+  ///
+  ///\param [in] length_in Hands over the time series length.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] range_in Hands over the distance range of the checks.
+  ///
+  ///\return true if a distance profile is expected to be faster than the
+  ///early abandoned similarity of the query to all subsequences.
+  ///
+  ///Each value of two z-normalized random subsequences adds about 2 to their
+  ///squared distance, i.e., an early abandoned similarity with range r
+  ///evaluates about r * r / 2 + 1 values. Both the transform and the
+  ///similarity take about the same time per operation, hence the profile
+  ///pays off if the similarities of one query evaluate more values than the
+  ///transform of size N has butterflies, i.e., N * log2(N). For the small
+  ///ranges of injected motifs the early abandoning usually wins.
+  bool preferDistanceProfile(const int length_in, const int window_in, const
+      double range_in);
+
+  ///\brief Checks whether a sweep of distance profiles pays off.
+  ///
+  ///\param [in] run_in Hands over the number of consecutive queries.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] range_in Hands over the distance range of the checks.
+  ///
+  ///\return true if a sweep over run_in consecutive subsequences is expected
+  ///to be faster than the early abandoned similarities.
+  ///
+  ///The first profile of a sweep costs about window operations per
+  ///subsequence and each further profile about 2, whereas the early abandoned
+  ///similarities cost about r * r / 2 + 5 operations per subsequence and
+  ///query, see preferDistanceProfile().
+  bool preferSweep(const int run_in, const int window_in, const double
+      range_in);
+
+  ///\brief This class represents the distance profiles of a time series.
+  ///
+  ///The DistanceProfile stores the spectrum of a time series and computes the
+  ///z-normalized Euclidean distance of a query to each subsequence with one
+  ///forward and one inverse transform of the query. Two queries are
+  ///transformed together as the real and imaginary part of one sequence,
+  ///i.e., two profiles cost as much as one. The time series is centered by
+  ///its mean, which keeps the dot products and their rounding errors small.
+  ///Standard deviations smaller than 1 are replaced by 1 as in the similarity
+  ///function of the TSGenerator.
+  class DistanceProfile {
+
+  protected:
+
+    ///\brief This variable stores the window size.
+    ///
+    ///The window size is the length of the subsequences.
+    int window = -1;
+
+    ///\brief This variable stores the size of the transform.
+    ///
+    ///The size is the smallest power of two not smaller than the length of
+    ///the time series.
+    int size = 1;
+
+    ///\brief This variable stores the center of the time series.
+    ///
+    ///The center is the mean of the time series.
+    double center = 0.0;
+
+    ///\brief This variable stores the norm of the time series.
+    ///
+    ///The norm is the Euclidean norm of the centered time series. It bounds
+    ///the rounding error of the dot products.
+    double norm = 0.0;
+
+    ///\brief This variable stores the largest absolute mean.
+    ///
+    ///This variable stores the largest absolute mean of a centered
+    ///subsequence.
+    double maxMean = 0.0;
+
+    ///\brief This variable stores the largest absolute value.
+    ///
+    ///This variable stores the largest absolute value of the centered time
+    ///series. It bounds the rounding error of the row updates.
+    double maxValue = 0.0;
+
+    ///\brief This variable stores the error bound.
+    ///
+    ///This variable stores the bound of the absolute error of the squared
+    ///distances of the last profile.
+    double error = 0.0;
+
+    ///\brief This variable stores the centered time series.
+    rseq centered;
+
+    ///\brief This variable stores the centered running mean.
+    rseq mean;
+
+    ///\brief This variable stores the running inverse standard deviation.
+    rseq rSigma;
+
+    ///\brief This variable stores the centered running sum.
+    rseq sums;
+
+    ///\brief This variable stores the energies.
+    ///
+    ///This variable stores the squared norm of each z-normalized
+    ///subsequence, i.e., about the window size or less if the standard
+    ///deviation was replaced by 1.
+    rseq energy;
+
+    ///\brief This variable stores the twiddle factors.
+    cseq twiddles;
+
+    ///\brief This variable stores the spectrum of the centered time series.
+    cseq spectrum;
+
+    ///\brief This variable stores the transform of the queries.
+    cseq buffer;
+
+    ///\brief This variable stores the dot products of the last sweep.
+    rseq row;
+
+    ///\brief This variable stores the dot products of the next sweep.
+    rseq nextRow;
+
+    ///\brief This variable stores the position of the last sweep.
+    ///
+    ///A negative value indicates that there is no row.
+    int rowPos = -1;
+
+    ///\brief This variable stores the error bound of the row.
+    ///
+    ///This variable stores the bound of the absolute error of the dot
+    ///products of the last sweep, which grows with each derived row.
+    double rowError = 0.0;
+
+
+    ///\brief Computes the spectrum of the time series.
+    ///
+    ///This function transforms the centered time series on the first use of
+    ///the spectrum, i.e., sweeps without transforms do not pay for it.
+    void transform();
+
+    ///\brief Returns the error bound of the transformed dot products.
+    ///
+    ///\param [in] *query_in Hands over the centered query.
+    ///
+    ///\return The bound of the absolute error of the dot products of the
+    ///query computed with the transforms.
+    double transformError(const double *query_in) const;
+
+
+    ///\brief Correlates two queries with the time series.
+    ///
+    ///\param [in] *query0_in Hands over the first centered query.
+    ///\param [in] *query1_in Hands over the second centered query or
+    ///nullptr.
+    ///
+    ///This function computes the dot products of the queries with all
+    ///subsequences. The dot products of the first query are stored in the
+    ///real part and the ones of the second query in the imaginary part of
+    ///the buffer.
+    void correlate(const double *query0_in, const double *query1_in);
+
+    ///\brief Derives a distance profile from the dot products.
+    ///
+    ///\param [in] *qt_in Hands over the dot products.
+    ///\param [in] stride_in Hands over the distance of consecutive dot
+    ///products.
+    ///\param [in] qtError_in Hands over the error bound of the dot products.
+    ///\param [in] *query_in Hands over the centered query.
+    ///\param [in] mean_in Hands over the centered mean of the query.
+    ///\param [in] rSigma_in Hands over the inverse standard deviation of the
+    ///query.
+    ///\param [in] energy_in Hands over the energy of the query.
+    ///\param [out] &profile_out Returns the distance profile.
+    void distances(const double *qt_in, const int stride_in, const double
+        qtError_in, const double *query_in, const double mean_in, const double
+        rSigma_in, const double energy_in, rseq &profile_out);
+
+  public:
+
+    ///\brief The constructor computes the spectrum of a time series.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics.
+    ///
+    ///The constructor centers the time series and computes the statistics of
+    ///the centered subsequences. The spectrum is computed once on its first
+    ///use. The object has to be rebuilt after the time series changed.
+    DistanceProfile(const rseq &timeSeries_in, const SubsequenceStats
+        &stats_in);
+
+    ///\brief Frees the memory allocated by the DistanceProfile.
+    ///
+    ///The destructor does actually nothing.
+    ~DistanceProfile();
+
+    ///\brief Computes the distance profile of a subsequence.
+    ///
+    ///\param [in] pos_in Hands over the position of the query subsequence.
+    ///\param [out] &profile_out Returns the distance of the query to each
+    ///subsequence.
+    void compute(const int pos_in, rseq &profile_out);
+
+    ///\brief Computes the distance profiles of two subsequences.
+    ///
+    ///\param [in] pos0_in Hands over the position of the first query
+    ///subsequence.
+    ///\param [in] pos1_in Hands over the position of the second query
+    ///subsequence.
+    ///\param [out] &profile0_out Returns the distance profile of the first
+    ///query.
+    ///\param [out] &profile1_out Returns the distance profile of the second
+    ///query.
+    ///
+    ///This function computes both profiles with a single pair of transforms.
+    void compute(const int pos0_in, const int pos1_in, rseq &profile0_out,
+        rseq &profile1_out);
+
+    ///\brief Computes the distance profile of an arbitrary query.
+    ///
+    ///\param [in] &query_in Hands over the query of length window.
+    ///\param [out] &profile_out Returns the distance of the query to each
+    ///subsequence.
+    void compute(const rseq &query_in, rseq &profile_out);
+
+    ///\brief Computes the distance profile of a subsequence of a sweep.
+    ///
+    ///\param [in] pos_in Hands over the position of the query subsequence.
+    ///\param [out] &profile_out Returns the distance of the query to each
+    ///subsequence.
+    ///
+    ///This function derives the dot products from the ones of the last sweep
+    ///in O(n) if the query follows the last query, like the rows of STOMP.
+    ///Otherwise the dot products are computed from scratch or with the
+    ///transforms, whichever is cheaper. Sweeping over consecutive
+    ///subsequences costs O(n) per profile instead of O(n * window).
+    void sweep(const int pos_in, rseq &profile_out);
+
+    ///\brief Returns the error bound of the last profile.
+    ///
+    ///\return The bound of the absolute error of the squared distances of the
+    ///last computed profiles.
+    ///
+    ///A subsequence is closer to the query than a range r only if its profile
+    ///value d satisfies d * d <= r * r + getError(), i.e., the profile is a
+    ///safe filter for exact distance checks.
+    double getError() const;
+  };
+}
+
+#endif
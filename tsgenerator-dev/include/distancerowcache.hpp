@@ -0,0 +1,162 @@
+///\file distancerowcache.hpp
+///
+///\brief File contains the DistanceRowCache class declaration.
+///
+///This is the header file of the DistanceRowCache. The DistanceRowCache stores
+///the similarities of subsequences to all subsequences of a time series and
+///keeps them valid across edits of the time series.
+
+#ifndef DISTANCEROWCACHE_HPP
+#define DISTANCEROWCACHE_HPP
+
+#include <cstdlib>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <tsgtypes.hpp>
+
+
+namespace tsg {
+
+  ///\brief This class represents a cache of distance rows.
+  ///
+  ///A distance row stores the early abandoned similarity of one subsequence
+  ///to each subsequence of the time series for one range, i.e., a value is
+  ///exact if it is within the range and a lower bound otherwise. An edit of
+  ///the time series drops the rows of the subsequences overlapping the edit
+  ///and marks the entries of these subsequences in all other rows as unknown,
+  ///i.e., negative. The rows are shared pointers, hence a row found by one
+  ///thread stays valid while other threads insert rows. The least recently
+  ///used rows are dropped if the rows exceed the capacity.
+  ///
+  ///The mutex guards the cache, but not the values of the rows. The callers
+  ///fill the unknown values of a row in place, hence a row may be used by one
+  ///thread at a time only, e.g., the parallel blocks of largerMotifSet()
+  ///handle disjoint subsequences.
+  class DistanceRowCache {
+
+  protected:
+
+    ///\brief This struct represents a cached row.
+    struct entry {
+
+      ///\brief The similarities of the row.
+      std::shared_ptr<rseq> row;
+
+      ///\brief The range of the early abandoned similarities.
+      double range;
+
+      ///\brief The position of the row in the order of use.
+      std::list<int>::iterator used;
+    };
+
+    ///\brief This variable stores the window size.
+    ///
+    ///The window size is the length of the subsequences.
+    int window = -1;
+
+    ///\brief This variable stores the capacity.
+    ///
+    ///The capacity is the maximum number of cached values.
+    std::size_t capacity = 0;
+
+    ///\brief This variable stores the number of cached values.
+    std::size_t size = 0;
+
+    ///\brief This variable stores the order of use.
+    ///
+    ///This variable stores the subsequence positions of the rows, the most
+    ///recently used row first, i.e., the least recently used row is dropped
+    ///in O(1).
+    std::list<int> order;
+
+    ///\brief This variable counts the rows found.
+    long hits = 0;
+
+    ///\brief This variable counts the rows not found.
+    long misses = 0;
+
+    ///\brief This variable stores the rows by subsequence position.
+    std::unordered_map<int, entry> rows;
+
+    ///\brief This variable guards the rows and counters.
+    mutable std::mutex mutex;
+
+
+    ///\brief Drops the least recently used rows.
+    ///
+    ///\param [in] values_in Hands over the number of values to make room
+    ///for.
+    ///
+    ///This function drops rows until values_in further values fit into the
+    ///capacity, each in O(1). The mutex has to be locked by the caller.
+    void evict(const std::size_t values_in);
+
+  public:
+
+    ///\brief The constructor initializes the DistanceRowCache.
+    ///
+    ///\param [in] window_in Hands over the window size.
+    ///\param [in] bytes_in Hands over the capacity in bytes.
+    DistanceRowCache(const int window_in, const std::size_t bytes_in);
+
+    ///\brief Frees the memory allocated by the DistanceRowCache.
+    ///
+    ///The destructor does actually nothing.
+    ~DistanceRowCache();
+
+    ///\brief Sets the capacity.
+    ///
+    ///\param [in] bytes_in Hands over the capacity in bytes.
+    ///
+    ///This function drops rows until they fit into the new capacity. A
+    ///capacity of 0 disables the cache.
+    void setCapacity(const std::size_t bytes_in);
+
+    ///\brief Finds a row.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [in] range_in Hands over the range of the similarities.
+    ///
+    ///\return The row or nullptr if there is no row of the subsequence for
+    ///the range.
+    std::shared_ptr<rseq> find(const int pos_in, const double range_in);
+
+    ///\brief Inserts a row.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [in] range_in Hands over the range of the similarities.
+    ///\param [in] &row_in Hands over the row.
+    ///
+    ///This function replaces an existing row of the subsequence and drops
+    ///the least recently used rows until the row fits into the capacity.
+    void insert(const int pos_in, const double range_in, const
+        std::shared_ptr<rseq> &row_in);
+
+    ///\brief Invalidates the rows touched by an edit.
+    ///
+    ///\param [in] pos_in Hands over the position of the edited window.
+    ///
+    ///This function drops the rows of the subsequences overlapping the edited
+    ///window and marks their entries in all other rows as unknown.
+    void invalidate(const int pos_in);
+
+    ///\brief Drops all rows and resets the counters.
+    void clear();
+
+    ///\brief Returns the number of rows found.
+    ///
+    ///\return The number of rows found since the last clear().
+    long getHits() const;
+
+    ///\brief Returns the number of rows not found.
+    ///
+    ///\return The number of rows not found since the last clear().
+    long getMisses() const;
+  };
+}
+
+#endif
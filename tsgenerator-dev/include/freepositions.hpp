@@ -11,6 +11,7 @@
 
 #include <random>
 #include <chrono>
+#include <algorithm>
 #include <tsgtypes.hpp>
 
 
@@ -37,11 +38,39 @@ namespace tsg {
     ///The free count is the number of free positions in the time series.
     int freeCount = -1;
 
+    ///\brief This variable stores the number of leaves of the tree.
+    ///
+    ///The number of leaves is the smallest power of two not smaller than the
+    ///number of positions in the time series.
+    int leaves = 1;
+
     ///\brief This variable contains the free positions.
     ///
-    ///This variable stores the positions of free subsequences in the time
-    ///series between the motif sets subsequences.
-    intervals freePositions;
+    ///This variable stores a segment tree counting the free positions of
+    ///subsequences in the time series between the motif sets subsequences.
+    ///The node i has the children 2i and 2i + 1 and the leaf of position p is
+    ///the node leaves + p. A node with count 0 is blocked as a whole, i.e.,
+    ///the counts of its descendants are outdated and never read.
+    iseq freePositions;
+
+    ///\brief This variable stores whether drawn positions are pending.
+    ///
+    ///The positions drawn with calculateRandomPositions are pending until
+    ///they are committed or rolled back. Meanwhile, all changes of the tree
+    ///are journaled.
+    bool pending = false;
+
+    ///\brief This variable stores the journaled nodes.
+    ///
+    ///The journaled nodes are the nodes of the tree changed since the pending
+    ///positions were drawn.
+    iseq journalNodes;
+
+    ///\brief This variable stores the journaled counts.
+    ///
+    ///The journaled counts are the counts of the journaled nodes before they
+    ///were changed.
+    iseq journalCounts;
 
     ///\brief This variable stores the random engine.
     ///
@@ -63,6 +92,20 @@ namespace tsg {
     ///This function calculates a random number in [0, freeCount].
     int randomNumber();
 
+    ///\brief Blocks the positions in a range.
+    ///
+    ///\param [in] node_in Hands over the node of the segment tree.
+    ///\param [in] low_in Hands over the first position of the node.
+    ///\param [in] high_in Hands over the last position of the node.
+    ///\param [in] start_in Hands over the first position to block.
+    ///\param [in] end_in Hands over the last position to block.
+    ///
+    ///This function sets the counts of all nodes inside the range to 0 and
+    ///updates the counts of the partially blocked nodes, i.e., it visits
+    ///O(log n) nodes.
+    void block(const int node_in, const int low_in, const int high_in, const
+        int start_in, const int end_in);
+
   public:
 
     ///\brief The constructor initializes the FreePositions.
@@ -86,13 +129,64 @@ namespace tsg {
     ///\return The random position in the time series.
     ///
     ///This function calculates a random free position in the time series
-    ///according to the window size.
+    ///according to the window size. The random number is decoded into the
+    ///free position of that rank by descending the segment tree in
+    ///O(log n).
     int calculateRandomPosition();
 
     ///\brief Removes position from free ones.
     ///
-    ///This function removes the position in randomPosition.
+    ///This function removes the position in randomPosition and blocks all
+    ///positions closer than twice the window size in O(log n).
     void removePosition();
+
+    ///\brief Removes a position from free ones.
+    ///
+    ///\param [in] pos_in Hands over a position previously calculated with
+    ///calculateRandomPosition().
+    ///
+    ///This function removes the position pos_in, which does not need to be
+    ///the most current random position.
+    void removePosition(const int pos_in);
+
+    ///\brief Calculates random free positions in the time series.
+    ///
+    ///\param [in] count_in Hands over the number of positions.
+    ///
+    ///\return The random positions in the time series.
+    ///
+    ///This function draws count_in random free positions, which are pairwise
+    ///at least twice the window size apart, in one call. Each position is
+    ///removed from the free ones as it is drawn, i.e., the function returns
+    ///fewer positions if the free positions run out. The positions are
+    ///pending until commitPositions or rollbackPositions is called.
+    iseq calculateRandomPositions(const int count_in);
+
+    ///\brief Commits the pending positions.
+    ///
+    ///This function keeps the positions drawn with calculateRandomPositions
+    ///and all positions removed since then removed.
+    void commitPositions();
+
+    ///\brief Rolls back the pending positions.
+    ///
+    ///This function frees the positions drawn with calculateRandomPositions
+    ///and all positions removed since then again. Positions of the batch to
+    ///be kept can be removed again with removePosition.
+    void rollbackPositions();
+
+    ///\brief Seeds the random engine.
+    ///
+    ///\param [in] seed_in Hands over the seed.
+    ///
+    ///This function seeds the random engine, i.e., the sequence of random
+    ///positions is reproducible.
+    void seed(const unsigned int seed_in);
+
+    ///\brief Returns the number of free positions.
+    ///
+    ///\return The number of free positions.
+    int getFreeCount() const;
   };
 }
 
@@ -0,0 +1,199 @@
+///\file matrixprofile.hpp
+///
+///\brief File contains the MatrixProfile class declaration.
+///
+///This is the header file of the MatrixProfile. The MatrixProfile stores the
+///nearest neighbor distance and index of each subsequence of a time series
+///and refreshes only the subsequences touched by an edit of the time series.
+
+#ifndef MATRIXPROFILE_HPP
+#define MATRIXPROFILE_HPP
+
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <tsgtypes.hpp>
+#include <subsequencestats.hpp>
+#include <tpm.hpp>
+
+
+namespace tsg {
+
+  ///\brief This class represents an incrementally maintained matrix profile.
+  ///
+  ///The MatrixProfile stores for each subsequence the squared z-normalized
+  ///Euclidean distance to its nearest non-trivial neighbor and the position
+  ///of the neighbor. Edits of the time series are registered with
+  ///invalidate() and the profile is refreshed lazily on the next query. Only
+  ///the rows and columns of the changed subsequences are recomputed, i.e., an
+  ///edit of a single window costs O(n * window) instead of O(n^2).
+  class MatrixProfile {
+
+  protected:
+
+    ///\brief This variable stores the window size.
+    ///
+    ///The window size is the length of the subsequences.
+    int window = -1;
+
+    ///\brief This variable stores the exclusion zone.
+    ///
+    ///Two subsequences are trivial matches if the absolute difference of their
+    ///positions is smaller than the exclusion zone.
+    int exclusion = -1;
+
+    ///\brief This variable stores the matrix profile.
+    ///
+    ///This variable stores the squared distance of each subsequence to its
+    ///nearest non-trivial neighbor.
+    rseq profile;
+
+    ///\brief This variable stores the matrix profile index.
+    ///
+    ///This variable stores the position of the nearest non-trivial neighbor of
+    ///each subsequence.
+    iseq index;
+
+    ///\brief This variable stores the changed subsequences.
+    ///
+    ///This variable flags each subsequence changed since the last refresh.
+    std::vector<char> changed;
+
+    ///\brief This variable stores the changed subsequences count.
+    ///
+    ///This variable stores the number of flagged subsequences. A negative
+    ///value indicates that the whole profile needs to be recomputed.
+    int changedCount = -1;
+
+
+    ///\brief Computes the whole matrix profile.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics.
+    ///\param [in] threads_in Hands over the number of threads.
+    ///
+    ///This function computes the whole profile with the matrixProfile()
+    ///procedure.
+    void computeAll(const rseq &timeSeries_in, const SubsequenceStats
+        &stats_in, const int threads_in);
+
+    ///\brief Recomputes rows and columns of the matrix profile.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] &mean_in Hands over the running mean.
+    ///\param [in] &rSigma_in Hands over the running inverse standard
+    ///deviation.
+    ///\param [in] &rows_in Hands over the ascending positions of the rows.
+    ///
+    ///This function computes the full distance rows of the given
+    ///subsequences. The dot products of a row are derived from the previous
+    ///row in O(n) per row in between if the rows are at most window apart and
+    ///computed from scratch in O(n * window) otherwise. Each distance also
+    ///updates the column minimum, since the distance matrix is symmetric.
+    void computeRows(const rseq &timeSeries_in, const rseq &mean_in, const rseq
+        &rSigma_in, const iseq &rows_in);
+
+  public:
+
+    ///\brief The constructor initializes the MatrixProfile.
+    ///
+    ///\param [in] window_in Hands over the window size.
+    ///\param [in] exclusion_in Hands over the exclusion zone.
+    ///
+    ///The constructor sets the window size and exclusion zone. The profile is
+    ///computed on the first query.
+    MatrixProfile(const int window_in, const int exclusion_in);
+
+    ///\brief Frees the memory allocated by the MatrixProfile.
+    ///
+    ///The destructor does actually nothing.
+    ~MatrixProfile();
+
+    ///\brief Invalidates the whole matrix profile.
+    ///
+    ///This function marks the whole profile for recomputation, e.g., after
+    ///a new time series was generated.
+    void invalidate();
+
+    ///\brief Invalidates the subsequences overlapping an edited window.
+    ///
+    ///\param [in] pos_in Hands over the position of the edited window.
+    ///
+    ///This function marks all subsequences overlapping the window at pos_in
+    ///for recomputation.
+    void invalidate(const int pos_in);
+
+    ///\brief Refreshes the matrix profile.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] &sums_in Hands over the running sum.
+    ///\param [in] &sumSquares_in Hands over the running sum of squares.
+    ///\param [in] threads_in Hands over the number of threads. A value
+    ///smaller than 1 uses all hardware threads.
+    ///
+    ///This function recomputes the rows and columns of all invalidated
+    ///subsequences as well as the rows of all subsequences whose nearest
+    ///neighbor was invalidated. If the rows cost more than half of the whole
+    ///profile, counting a row from scratch as window rows, the whole profile
+    ///is recomputed in parallel instead.
+    void refresh(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+        &sumSquares_in, const int threads_in = 1);
+
+    ///\brief Refreshes the matrix profile with precomputed statistics.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics.
+    ///\param [in] threads_in Hands over the number of threads. A value
+    ///smaller than 1 uses all hardware threads.
+    void refresh(const rseq &timeSeries_in, const SubsequenceStats &stats_in,
+        const int threads_in = 1);
+
+    ///\brief Returns the top pair motif.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] &sums_in Hands over the running sum.
+    ///\param [in] &sumSquares_in Hands over the running sum of squares.
+    ///\param [out] &pos0_out Returns the position of the first subsequence.
+    ///\param [out] &pos1_out Returns the position of the second subsequence.
+    ///\param [in] threads_in Hands over the number of threads.
+    ///
+    ///\return The distance of the top pair motif.
+    ///
+    ///This function refreshes the profile and returns the pair of
+    ///subsequences with the smallest distance.
+    double topPair(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+        &sumSquares_in, int &pos0_out, int &pos1_out, const int threads_in
+        = 1);
+
+    ///\brief Returns the top pair motif with precomputed statistics.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics.
+    ///\param [out] &pos0_out Returns the position of the first subsequence.
+    ///\param [out] &pos1_out Returns the position of the second subsequence.
+    ///\param [in] threads_in Hands over the number of threads.
+    ///
+    ///\return The distance of the top pair motif.
+    double topPair(const rseq &timeSeries_in, const SubsequenceStats
+        &stats_in, int &pos0_out, int &pos1_out, const int threads_in = 1);
+
+    ///\brief Returns the nearest neighbor distance of a subsequence.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///
+    ///\return The distance to the nearest neighbor as of the last refresh.
+    double distance(const int pos_in) const;
+
+    ///\brief Returns the nearest neighbor position of a subsequence.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///
+    ///\return The position of the nearest neighbor as of the last refresh.
+    int neighbor(const int pos_in) const;
+  };
+}
+
+#endif
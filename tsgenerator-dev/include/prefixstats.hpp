@@ -0,0 +1,125 @@
+///\file prefixstats.hpp
+///
+///\brief File contains the PrefixStats class declaration.
+///
+///This is the header file of the PrefixStats. The PrefixStats stores the
+///compensated prefix sums of a time series, which answer the mean and the
+///standard deviation of any subsequence in constant time.
+
+#ifndef PREFIXSTATS_HPP
+#define PREFIXSTATS_HPP
+
+#include <cmath>
+#include <algorithm>
+#include <tsgtypes.hpp>
+#include <runningstats.hpp>
+
+
+namespace tsg {
+
+  ///\brief This class represents the prefix statistics of a time series.
+  ///
+  ///The PrefixStats stores the prefix sum and the prefix sum of squares of a
+  ///time series as unevaluated sums of a high and a low part, i.e., in
+  ///double-double precision. The statistics of a subsequence are the
+  ///differences of two prefixes, hence one pass over the time series serves
+  ///any window size and any subsequence length. The precision of the prefixes
+  ///keeps the variance accurate for long time series with large offsets.
+  class PrefixStats {
+
+  protected:
+
+    ///\brief This variable stores the high part of the prefix sum.
+    ///
+    ///The element i is the rounded sum of the first i values.
+    rseq sumHigh;
+
+    ///\brief This variable stores the low part of the prefix sum.
+    ///
+    ///The element i is the rounding error of the high part.
+    rseq sumLow;
+
+    ///\brief This variable stores the high part of the prefix sum of squares.
+    ///
+    ///The element i is the rounded sum of the first i squared values.
+    rseq squareHigh;
+
+    ///\brief This variable stores the low part of the prefix sum of squares.
+    ///
+    ///The element i is the rounding error of the high part.
+    rseq squareLow;
+
+
+    ///\brief Computes the sums of a subsequence.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [in] length_in Hands over the length of the subsequence.
+    ///\param [out] &sumHigh_out Returns the high part of the sum.
+    ///\param [out] &sumLow_out Returns the low part of the sum.
+    ///\param [out] &squareHigh_out Returns the high part of the sum of
+    ///squares.
+    ///\param [out] &squareLow_out Returns the low part of the sum of squares.
+    void sums(const int pos_in, const int length_in, double &sumHigh_out,
+        double &sumLow_out, double &squareHigh_out, double &squareLow_out)
+      const;
+
+  public:
+
+    ///\brief The constructor initializes the PrefixStats.
+    ///
+    ///The statistics are empty until compute() is called.
+    PrefixStats();
+
+    ///\brief The constructor computes the PrefixStats.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    PrefixStats(const rseq &timeSeries_in);
+
+    ///\brief Frees the memory allocated by the PrefixStats.
+    ///
+    ///The destructor does actually nothing.
+    ~PrefixStats();
+
+    ///\brief Computes the prefix sums of a time series.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///
+    ///This function computes the prefix sums in one pass with two-sum
+    ///additions and exact squares.
+    void compute(const rseq &timeSeries_in);
+
+    ///\brief Returns the mean of a subsequence.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [in] length_in Hands over the length of the subsequence.
+    ///
+    ///\return The mean of the subsequence.
+    double getMean(const int pos_in, const int length_in) const;
+
+    ///\brief Returns the variance of a subsequence.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [in] length_in Hands over the length of the subsequence.
+    ///
+    ///\return The variance of the subsequence.
+    ///
+    ///This function evaluates length^2 * variance = length * sum of squares -
+    ///sum^2 in double-double precision, i.e., without cancellation.
+    double getVariance(const int pos_in, const int length_in) const;
+
+    ///\brief Returns the standard deviation of a subsequence.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [in] length_in Hands over the length of the subsequence.
+    ///
+    ///\return The standard deviation of the subsequence.
+    double getStdDev(const int pos_in, const int length_in) const;
+
+    ///\brief Returns the length of the time series.
+    ///
+    ///\return The number of values of the time series.
+    int size() const;
+  };
+}
+
+#endif
@@ -0,0 +1,205 @@
+///\file runningstats.hpp
+///
+///\brief File contains the RunningStats class declaration.
+///
+///This is the header file of the RunningStats. The RunningStats maintains the
+///running sum and sum of squares of all subsequences of a time series with
+///compensated updates anchored to exact recomputations.
+
+#ifndef RUNNINGSTATS_HPP
+#define RUNNINGSTATS_HPP
+
+#include <cmath>
+#include <algorithm>
+#include <tsgtypes.hpp>
+
+
+namespace tsg {
+
+  ///\brief The number of subsequences between two exact recomputations.
+  ///
+  ///The running sums are recomputed exactly at the first subsequence of each
+  ///block of runningStatsBlock subsequences and rolled from there.
+  const int runningStatsBlock = 1024;
+
+  ///\brief Adds a value to a compensated sum.
+  ///
+  ///\param [in,out] &sum_inout Hands over and returns the sum.
+  ///\param [in,out] &error_inout Hands over and returns the rounding errors
+  ///of the sum.
+  ///\param [in] value_in Hands over the value.
+  ///
+  ///This function adds the value with the two-sum algorithm, i.e., the
+  ///rounding error of the addition is added to the error exactly.
+  inline void twoSum(double &sum_inout, double &error_inout, const double
+      value_in) {
+
+    double sum = sum_inout + value_in;
+    double virtualValue = sum - sum_inout;
+
+    error_inout += (sum_inout - (sum - virtualValue)) + (value_in
+        - virtualValue);
+    sum_inout = sum;
+  }
+
+  ///\brief Multiplies two values without rounding error.
+  ///
+  ///\param [in] a_in Hands over the first factor.
+  ///\param [in] b_in Hands over the second factor.
+  ///\param [out] &error_out Returns the rounding error of the product.
+  ///
+  ///\return The rounded product.
+  ///
+  ///This function splits the factors into halves with Dekker's algorithm,
+  ///i.e., the product plus the error is the exact product. The callers are
+  ///built without floating point contraction.
+  inline double twoProduct(const double a_in, const double b_in, double
+      &error_out) {
+
+    const double splitter = 134217729.0;
+    double product = a_in * b_in;
+    double t = splitter * a_in;
+    double aHigh = t - (t - a_in);
+    double aLow = a_in - aHigh;
+
+    t = splitter * b_in;
+
+    double bHigh = t - (t - b_in);
+    double bLow = b_in - bHigh;
+
+    error_out = ((aHigh * bHigh - product) + aHigh * bLow + aLow * bHigh)
+      + aLow * bLow;
+
+    return product;
+  }
+
+  ///\brief This class represents the running statistics of a time series.
+  ///
+  ///The RunningStats stores the running sum and sum of squares of the values
+  ///of each subsequence shifted by the first value of its block, i.e., the
+  ///sums stay small even if the time series has a large offset and the
+  ///variance does not cancel catastrophically. The sums are rolled from one
+  ///subsequence to the next with two-sum compensated additions, recomputed
+  ///exactly at the first subsequence of each block and at the first
+  ///subsequence of each update. Hence, the errors neither grow with the
+  ///length of the time series nor with the number of updates.
+  class RunningStats {
+
+  protected:
+
+    ///\brief This variable stores the window size.
+    ///
+    ///The window size is the length of the subsequences.
+    int window = -1;
+
+    ///\brief This variable stores the shifts.
+    ///
+    ///This variable stores the shift of each block, i.e., the first value of
+    ///the block when the statistics were computed.
+    rseq shift;
+
+    ///\brief This variable stores the shifted running sum.
+    ///
+    ///This variable stores the sum of the shifted values of each subsequence.
+    rseq sums;
+
+    ///\brief This variable stores the shifted running sum of squares.
+    ///
+    ///This variable stores the sum of the squared shifted values of each
+    ///subsequence.
+    rseq sumSquares;
+
+
+    ///\brief Computes the running sums of a range of subsequences.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] start_in Hands over the first subsequence.
+    ///\param [in] end_in Hands over the end of the range.
+    ///
+    ///This function recomputes the running sums of the subsequences in
+    ///[start_in, end_in) exactly at start_in and at each block start and
+    ///rolls them in between.
+    void computeRange(const rseq &timeSeries_in, const int start_in, const
+        int end_in);
+
+  public:
+
+    ///\brief The constructor initializes the RunningStats.
+    ///
+    ///\param [in] window_in Hands over the window size.
+    ///
+    ///The constructor sets the window size. The statistics are empty until
+    ///compute() is called.
+    RunningStats(const int window_in);
+
+    ///\brief Frees the memory allocated by the RunningStats.
+    ///
+    ///The destructor does actually nothing.
+    ~RunningStats();
+
+    ///\brief Computes the running statistics of all subsequences.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///
+    ///This function chooses the shifts of the blocks and computes the running
+    ///sums of all subsequences, e.g., after a new time series was generated.
+    void compute(const rseq &timeSeries_in);
+
+    ///\brief Updates the running statistics around a position.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] pos_in Hands over the position of the edited window.
+    ///
+    ///This function recomputes the running sums of all subsequences
+    ///overlapping the window at pos_in in O(window).
+    void update(const rseq &timeSeries_in, const int pos_in);
+
+    ///\brief Copies the running statistics around a position.
+    ///
+    ///\param [in] &runnings_in Hands over the running statistics to copy.
+    ///\param [in] pos_in Hands over the position of the edited window.
+    ///
+    ///This function copies the running sums of all subsequences overlapping
+    ///the window at pos_in bitwise, e.g., to restore a speculative copy.
+    void update(const RunningStats &runnings_in, const int pos_in);
+
+    ///\brief Returns the running sum and sum of squares of a range.
+    ///
+    ///\param [in] start_in Hands over the first subsequence.
+    ///\param [in] end_in Hands over the end of the range.
+    ///\param [in,out] &sums_inout Returns the running sum.
+    ///\param [in,out] &sumSquares_inout Returns the running sum of squares.
+    ///
+    ///This function writes the unshifted running sum and sum of squares of
+    ///the subsequences in [start_in, end_in), i.e., the values calcRunnings
+    ///of the utilities computes.
+    void getRunnings(const int start_in, const int end_in, rseq &sums_inout,
+        rseq &sumSquares_inout) const;
+
+    ///\brief Returns the mean of a subsequence.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///
+    ///\return The mean of the subsequence.
+    double getMean(const int pos_in) const;
+
+    ///\brief Returns the variance of a subsequence.
+    ///
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///
+    ///\return The variance of the subsequence.
+    double getVariance(const int pos_in) const;
+
+    ///\brief Returns the window size.
+    ///
+    ///\return The window size.
+    int getWindow() const;
+
+    ///\brief Returns the number of subsequences.
+    ///
+    ///\return The number of subsequences.
+    int size() const;
+  };
+}
+
+#endif
@@ -0,0 +1,235 @@
+///\file subsequencestats.hpp
+///
+///\brief File contains the SubsequenceStats class declaration.
+///
+///This is the header file of the SubsequenceStats. The SubsequenceStats
+///stores the mean and inverse standard deviation of all subsequences of a
+///time series in contiguous arrays.
+
+#ifndef SUBSEQUENCESTATS_HPP
+#define SUBSEQUENCESTATS_HPP
+
+#include <cmath>
+#include <algorithm>
+#include <tsgtypes.hpp>
+#include <runningstats.hpp>
+#include <prefixstats.hpp>
+
+
+namespace tsg {
+
+  ///\brief The shortest segment whose means are taken from prefix sums.
+  ///
+  ///A segment mean summed directly costs one addition per value, a segment
+  ///mean of the PrefixStats costs a constant number of operations for any
+  ///segment length. Both took about the same time for segments of 64 values.
+  const int prefixSegment = 64;
+
+  ///\brief This class represents the statistics of all subsequences.
+  ///
+  ///The SubsequenceStats stores the mean and inverse standard deviation of
+  ///each subsequence derived from the running sum and sum of squares. Standard
+  ///deviations smaller than 1 are replaced by 1. The statistics are computed
+  ///once and updated next to the running sums, such that the distance kernels
+  ///neither allocate nor divide.
+  class SubsequenceStats {
+
+  protected:
+
+    ///\brief This variable stores the window size.
+    ///
+    ///The window size is the length of the subsequences.
+    int window = -1;
+
+    ///\brief This variable stores the running mean.
+    ///
+    ///This variable stores the mean of each subsequence.
+    rseq mean;
+
+    ///\brief This variable stores the running inverse standard deviation.
+    ///
+    ///This variable stores the inverse standard deviation of each
+    ///subsequence, i.e., the distance kernels multiply instead of divide.
+    rseq rSigma;
+
+    ///\brief This variable stores the segment length.
+    ///
+    ///The segment length is the number of values averaged by one element of
+    ///the piecewise aggregate approximation. A value smaller than 1 disables
+    ///the lower bound.
+    int segment = 0;
+
+    ///\brief This variable stores the running segment mean.
+    ///
+    ///This variable stores the mean of the segment length values starting at
+    ///each position of the time series.
+    rseq segmentMean;
+
+
+    ///\brief Computes the statistics of a range of subsequences.
+    ///
+    ///\param [in] &sums_in Hands over the running sum.
+    ///\param [in] &sumSquares_in Hands over the running sum of squares.
+    ///\param [in] start_in Hands over the first subsequence.
+    ///\param [in] end_in Hands over the subsequence behind the last one.
+    void computeRange(const rseq &sums_in, const rseq &sumSquares_in, const int
+        start_in, const int end_in);
+
+    ///\brief Computes the statistics of a range of subsequences.
+    ///
+    ///\param [in] &runnings_in Hands over the running statistics.
+    ///\param [in] start_in Hands over the first subsequence.
+    ///\param [in] end_in Hands over the end of the range.
+    ///
+    ///This function computes the statistics of the subsequences in
+    ///[start_in, end_in) from the means and variances of the running
+    ///statistics.
+    void computeRange(const RunningStats &runnings_in, const int start_in,
+        const int end_in);
+
+    ///\brief Computes the segment means of a range of positions.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] start_in Hands over the first position.
+    ///\param [in] end_in Hands over the position behind the last one.
+    ///
+    ///Each segment mean is summed directly from the time series, i.e., it
+    ///does not depend on the order of the updates.
+    void computeSegmentRange(const rseq &timeSeries_in, const int start_in,
+        const int end_in);
+
+  public:
+
+    ///\brief The constructor initializes the SubsequenceStats.
+    ///
+    ///\param [in] window_in Hands over the window size.
+    ///
+    ///The constructor sets the window size. The statistics are empty until
+    ///compute() is called.
+    SubsequenceStats(const int window_in);
+
+    ///\brief The constructor computes the SubsequenceStats.
+    ///
+    ///\param [in] window_in Hands over the window size.
+    ///\param [in] &sums_in Hands over the running sum.
+    ///\param [in] &sumSquares_in Hands over the running sum of squares.
+    ///
+    ///The constructor sets the window size and computes the statistics of
+    ///all subsequences.
+    SubsequenceStats(const int window_in, const rseq &sums_in, const rseq
+        &sumSquares_in);
+
+    ///\brief Frees the memory allocated by the SubsequenceStats.
+    ///
+    ///The destructor does actually nothing.
+    ~SubsequenceStats();
+
+    ///\brief Computes the statistics of all subsequences.
+    ///
+    ///\param [in] &sums_in Hands over the running sum.
+    ///\param [in] &sumSquares_in Hands over the running sum of squares.
+    ///
+    ///This function computes the mean and inverse standard deviation of all
+    ///subsequences, e.g., after a new time series was generated.
+    void compute(const rseq &sums_in, const rseq &sumSquares_in);
+
+    ///\brief Updates the statistics of the subsequences around a position.
+    ///
+    ///\param [in] &sums_in Hands over the running sum.
+    ///\param [in] &sumSquares_in Hands over the running sum of squares.
+    ///\param [in] pos_in Hands over the position of the edited window.
+    ///
+    ///This function recomputes the statistics of all subsequences overlapping
+    ///the window at pos_in, i.e., the subsequences whose running sums were
+    ///updated.
+    void update(const rseq &sums_in, const rseq &sumSquares_in, const int
+        pos_in);
+
+    ///\brief Computes the statistics of all subsequences.
+    ///
+    ///\param [in] &runnings_in Hands over the running statistics.
+    ///
+    ///This function computes the mean and inverse standard deviation of all
+    ///subsequences from the compensated running statistics, i.e., without
+    ///the cancellation of the running sum of squares.
+    void compute(const RunningStats &runnings_in);
+
+    ///\brief Updates the statistics of the subsequences around a position.
+    ///
+    ///\param [in] &runnings_in Hands over the running statistics.
+    ///\param [in] pos_in Hands over the position of the edited window.
+    ///
+    ///This function recomputes the statistics of all subsequences overlapping
+    ///the window at pos_in from the running statistics.
+    void update(const RunningStats &runnings_in, const int pos_in);
+
+    ///\brief Computes the statistics of all subsequences.
+    ///
+    ///\param [in] &prefix_in Hands over the prefix statistics.
+    ///
+    ///This function computes the mean and inverse standard deviation of all
+    ///subsequences of the window size from the prefix statistics, i.e., the
+    ///statistics of several window sizes share one pass over the time series.
+    void compute(const PrefixStats &prefix_in);
+
+    ///\brief Computes the segment means of a time series.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] segment_in Hands over the segment length.
+    ///
+    ///This function enables the lower bound with the piecewise aggregate
+    ///approximation of window / segment_in segments. Segments of at least
+    ///prefixSegment values are averaged with the PrefixStats of the time
+    ///series in O(n), shorter ones directly in O(n * segment_in).
+    void computeSegments(const rseq &timeSeries_in, const int segment_in);
+
+    ///\brief Updates the segment means around a position.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] pos_in Hands over the position of the edited window.
+    ///
+    ///This function recomputes the segment means overlapping the window at
+    ///pos_in.
+    void updateSegments(const rseq &timeSeries_in, const int pos_in);
+
+    ///\brief Computes a lower bound of the similarity of two subsequences.
+    ///
+    ///\param [in] pos0_in Hands over the position of the first subsequence.
+    ///\param [in] pos1_in Hands over the position of the second subsequence.
+    ///\param [in] bestSoFar_in Hands over the best similarity so far.
+    ///
+    ///\return A lower bound of the z-normalized Euclidean distance or 0 if
+    ///the segment means are not computed.
+    ///
+    ///The bound is the Euclidean distance of the piecewise aggregate
+    ///approximations of the z-normalized subsequences scaled by the square
+    ///root of the segment length, like the PAA distance of the TSM. It only
+    ///reads the segment means and the statistics, not the time series, and
+    ///is abandoned as soon as it exceeds bestSoFar_in. The bound is lowered
+    ///by 1e-9 * window to absorb rounding errors.
+    double lowerBound(const int pos0_in, const int pos1_in, const double
+        bestSoFar_in) const;
+
+    ///\brief Returns the window size.
+    ///
+    ///\return The window size.
+    int getWindow() const;
+
+    ///\brief Returns the number of subsequences.
+    ///
+    ///\return The number of subsequences.
+    int size() const;
+
+    ///\brief Returns the running mean.
+    ///
+    ///\return The mean of each subsequence.
+    const rseq &getMean() const;
+
+    ///\brief Returns the running inverse standard deviation.
+    ///
+    ///\return The inverse standard deviation of each subsequence.
+    const rseq &getRSigma() const;
+  };
+}
+
+#endif
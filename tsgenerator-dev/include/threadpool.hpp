@@ -0,0 +1,126 @@
+///\file threadpool.hpp
+///
+///\brief File contains the ThreadPool class declaration.
+///
+///This is the header file of the ThreadPool. The ThreadPool runs blocks of
+///work on persistent threads, i.e., the threads are spawned once and reused
+///by all parallel procedures.
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace tsg {
+
+  ///\brief This class represents a pool of persistent threads.
+  ///
+  ///The pool runs the blocks of one job at a time. The blocks are handed to
+  ///the threads of the pool and to the calling thread through an atomic
+  ///cursor, i.e., the order in which blocks are finished is arbitrary and the
+  ///callers write the result of each block into a slot of its own. A job
+  ///started within a block of another job runs serially in the calling
+  ///thread, hence nested parallel procedures do not deadlock.
+  class ThreadPool {
+
+  protected:
+
+    ///\brief This variable stores the threads.
+    std::vector<std::thread> threads;
+
+    ///\brief This variable stores the block function of the current job.
+    const std::function<void(const int)> *job = nullptr;
+
+    ///\brief This variable stores the number of blocks of the current job.
+    int blocks = 0;
+
+    ///\brief This variable stores the next block to hand out.
+    std::atomic<int> next;
+
+    ///\brief This variable counts the threads working on the current job.
+    int busy = 0;
+
+    ///\brief This variable counts the jobs started.
+    long jobs = 0;
+
+    ///\brief This variable tells the threads to finish.
+    bool stop = false;
+
+    ///\brief This variable stores the first exception thrown by a block.
+    std::exception_ptr error;
+
+    ///\brief This variable guards the job and the counters.
+    std::mutex mutex;
+
+    ///\brief This variable serializes the jobs of different callers.
+    std::mutex running;
+
+    ///\brief This variable wakes the threads for a new job.
+    std::condition_variable wake;
+
+    ///\brief This variable wakes the caller once the threads are done.
+    std::condition_variable done;
+
+
+    ///\brief Runs the blocks of the current job.
+    ///
+    ///\param [in] &job_in Hands over the block function.
+    ///\param [in] blocks_in Hands over the number of blocks.
+    ///
+    ///This function takes blocks from the cursor until all blocks are handed
+    ///out and stores the first exception thrown.
+    void work(const std::function<void(const int)> &job_in, const int
+        blocks_in);
+
+    ///\brief Waits for jobs and runs them.
+    void loop();
+
+  public:
+
+    ///\brief The constructor initializes the ThreadPool.
+    ///
+    ///The threads are spawned by the first job needing them.
+    ThreadPool();
+
+    ///\brief Frees the memory allocated by the ThreadPool.
+    ///
+    ///The destructor joins the threads.
+    ~ThreadPool();
+
+    ///\brief Returns the pool shared by all procedures.
+    ///
+    ///\return The shared pool.
+    static ThreadPool &shared();
+
+    ///\brief Returns the number of workers.
+    ///
+    ///\param [in] threads_in Hands over the number of threads. A value
+    ///smaller than 1 uses all hardware threads.
+    ///
+    ///\return The number of workers, at least 1.
+    static int workers(const int threads_in);
+
+    ///\brief Runs blocks in parallel.
+    ///
+    ///\param [in] blocks_in Hands over the number of blocks.
+    ///\param [in] &block_in Hands over the function computing one block.
+    ///
+    ///This function calls block_in once for each block index in [0,
+    ///blocks_in) on blocks_in threads, the calling thread included, and
+    ///returns once all blocks are done. The first exception thrown by a
+    ///block is rethrown.
+    void run(const int blocks_in, const std::function<void(const int)>
+        &block_in);
+  };
+}
+
+#endif
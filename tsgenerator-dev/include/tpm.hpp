@@ -3,17 +3,25 @@
 ///\brief File contains a top pair motif discovery algorithm.
 ///
 ///This algorithm computes the top pair motif of a time series by evaluating
-///iteratively the diagonals of the distance matrix of the time series.
+///iteratively the diagonals of the distance matrix of the time series. All
+///procedures share one diagonal traversal engine and only differ in the
+///reducer applied to the distances.
 
 #ifndef TPM_HPP
 #define TPM_HPP
 
 #include <cstdlib>
 #include <cmath>
+#include <iostream>
 #include <iomanip>
 #include <limits>
 #include <algorithm>
+#include <thread>
+#include <vector>
+#include <random>
+#include <chrono>
 #include <tsgtypes.hpp>
+#include <subsequencestats.hpp>
 
 
 namespace tsg {
@@ -32,6 +40,383 @@ namespace tsg {
   ///the distance matrix of the time series.
   double tpm(const rseq &timeSeries_in, const rseq &sums_in, const rseq
       &sumSquares_in, int &pos0_out, int &pos1_out, const int window_in);
+
+  ///\brief The parallel top pair motif dicovery procedure.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &sums_in Hands over the running sum.
+  ///\param [in] &sumSquares_in Hands over the running sum of squares.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///This is the parallel version of the top pair motif discovery algorithm.
+  ///The diagonals of the distance matrix are split into contiguous blocks of
+  ///equal work, one per thread. The best pairs of the blocks are reduced in
+  ///diagonal order, such that ties are broken exactly as in the serial
+  ///version and the result is identical.
+  double tpm(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, int &pos0_out, int &pos1_out, const int window_in,
+      const int threads_in);
+
+  ///\brief The top pair motif dicovery procedure on precomputed statistics.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &stats_in Hands over the precomputed subsequence statistics.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///This is the parallel top pair motif discovery algorithm. The window size
+  ///is the one of the statistics, which are reused instead of recomputed.
+  double tpm(const rseq &timeSeries_in, const SubsequenceStats &stats_in, int
+      &pos0_out, int &pos1_out, const int threads_in = 1);
+
+  ///\brief The anytime top pair motif dicovery procedure.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &sums_in Hands over the running sum.
+  ///\param [in] &sumSquares_in Hands over the running sum of squares.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] seconds_in Hands over the time budget in seconds. A value
+  ///smaller than or equal to 0 disables the time budget.
+  ///\param [in] diagonals_in Hands over the diagonal budget. A value smaller
+  ///than 1 disables the diagonal budget.
+  ///\param [in,out] &randomEngine_in Hands over the random engine used to
+  ///shuffle the diagonals.
+  ///\param [out] &fraction_out Returns the fraction of evaluated diagonals.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///\return The distance of the best pair found so far.
+  ///
+  ///This is an anytime version of the top pair motif discovery algorithm
+  ///similar to SCRIMP. The diagonals are visited in random order in small
+  ///blocks of consecutive diagonals, such that the SIMD kernels are still
+  ///used. The threads take the shuffled blocks one after the other and the
+  ///results are merged in shuffle order. The procedure stops as soon as one
+  ///of the budgets is exhausted, but evaluates at least one block per
+  ///thread. The result is an upper bound of the top pair motif distance and
+  ///exact if fraction_out is 1.
+  ///
+  ///With the diagonal budget alone the evaluated blocks are fixed before the
+  ///traversal, i.e., the result only depends on the random engine. With a
+  ///time budget the number of evaluated blocks depends on the timing and the
+  ///number of threads, i.e., the result is not reproducible.
+  double tpmAnytime(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, int &pos0_out, int &pos1_out, const int window_in,
+      const double seconds_in, const int diagonals_in, std::mt19937
+      &randomEngine_in, double &fraction_out, const int threads_in = 1);
+
+  ///\brief The anytime top pair motif dicovery procedure on precomputed
+  ///statistics.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &stats_in Hands over the precomputed subsequence statistics.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///\param [in] seconds_in Hands over the time budget in seconds.
+  ///\param [in] diagonals_in Hands over the diagonal budget.
+  ///\param [in,out] &randomEngine_in Hands over the random engine.
+  ///\param [out] &fraction_out Returns the fraction of evaluated diagonals.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///\return The distance of the best pair found so far.
+  double tpmAnytime(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, int &pos0_out, int &pos1_out, const double seconds_in, const
+      int diagonals_in, std::mt19937 &randomEngine_in, double &fraction_out,
+      const int threads_in = 1);
+
+  ///\brief The minimum and maximum distance procedure.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &sums_in Hands over the running sum.
+  ///\param [in] &sumSquares_in Hands over the running sum of squares.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [out] &min_out Returns the minimum squared distance of two
+  ///subsequences.
+  ///\param [out] &max_out Returns the maximum squared distance of two
+  ///subsequences.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///This algorithm computes the minimum and maximum squared z-normalized
+  ///Euclidean distance of two non overlapping subsequences with the same
+  ///diagonal traversal and SIMD kernels as the top pair motif discovery.
+  void tpmMinMax(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, const int window_in, double &min_out, double &max_out,
+      const int threads_in = 1);
+
+  ///\brief The minimum and maximum distance procedure on precomputed
+  ///statistics.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &stats_in Hands over the precomputed subsequence statistics.
+  ///\param [out] &min_out Returns the minimum squared distance.
+  ///\param [out] &max_out Returns the maximum squared distance.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  void tpmMinMax(const rseq &timeSeries_in, const SubsequenceStats &stats_in,
+      double &min_out, double &max_out, const int threads_in = 1);
+
+  ///\brief The distance histogram procedure.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &sums_in Hands over the running sum.
+  ///\param [in] &sumSquares_in Hands over the running sum of squares.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] min_in Hands over the lower bound of the first bin.
+  ///\param [in] max_in Hands over the upper bound of the last bin.
+  ///\param [in] bins_in Hands over the number of bins.
+  ///\param [out] &counts_out Returns the number of pairs per bin.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///This algorithm counts the z-normalized Euclidean distances of all pairs
+  ///of non overlapping subsequences in bins_in bins of equal width between
+  ///min_in and max_in. Distances outside of the range are counted in the
+  ///first or last bin.
+  void tpmHistogram(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, const int window_in, const double min_in, const double
+      max_in, const int bins_in, lseq &counts_out, const int threads_in = 1);
+
+  ///\brief The distance histogram procedure on precomputed statistics.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &stats_in Hands over the precomputed subsequence statistics.
+  ///\param [in] min_in Hands over the lower bound of the first bin.
+  ///\param [in] max_in Hands over the upper bound of the last bin.
+  ///\param [in] bins_in Hands over the number of bins.
+  ///\param [out] &counts_out Returns the number of pairs per bin.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  void tpmHistogram(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, const double min_in, const double max_in, const int bins_in,
+      lseq &counts_out, const int threads_in = 1);
+
+  ///\brief The distance threshold count procedure.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &sums_in Hands over the running sum.
+  ///\param [in] &sumSquares_in Hands over the running sum of squares.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] threshold_in Hands over the distance threshold.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///\return The number of pairs closer than the threshold.
+  ///
+  ///This algorithm counts the pairs of non overlapping subsequences with
+  ///a z-normalized Euclidean distance smaller than threshold_in.
+  long long tpmCount(const rseq &timeSeries_in, const rseq &sums_in, const
+      rseq &sumSquares_in, const int window_in, const double threshold_in,
+      const int threads_in = 1);
+
+  ///\brief The distance threshold count procedure on precomputed statistics.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &stats_in Hands over the precomputed subsequence statistics.
+  ///\param [in] threshold_in Hands over the distance threshold.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///\return The number of pairs closer than the threshold.
+  long long tpmCount(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, const double threshold_in, const int threads_in = 1);
+
+  ///\brief The top k pair motifs discovery procedure.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &sums_in Hands over the running sum.
+  ///\param [in] &sumSquares_in Hands over the running sum of squares.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] k_in Hands over the number of pair motifs.
+  ///\param [out] &pos0_out Returns the positions of the first subsequences.
+  ///\param [out] &pos1_out Returns the positions of the second subsequences.
+  ///\param [out] &d_out Returns the distances of the pair motifs.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///This algorithm computes up to k_in pair motifs in ascending order of their
+  ///distance. Two pairs overlap if both their first and their second
+  ///subsequences overlap. The pairs are selected exactly like by a sort of
+  ///all pairs in ascending order of the distance, ties in traversal order,
+  ///i.e., by diagonal and row, and a scan keeping each pair that does not
+  ///overlap a kept pair. The first pair is always the top pair motif.
+  ///
+  ///The first traversal keeps up to 4 k_in non overlapping pairs greedily.
+  ///One pair overlaps at most four non overlapping pairs, hence the scan
+  ///keeps k_in pairs before it reaches a pair worse than the worst of them.
+  ///The second traversal collects all pairs up to this bound, which are
+  ///sorted and scanned. The result does not depend on the number of threads.
+  void tpmTopK(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, const int window_in, const int k_in, iseq &pos0_out,
+      iseq &pos1_out, rseq &d_out, const int threads_in = 1);
+
+  ///\brief The top k pair motifs discovery procedure on precomputed
+  ///statistics.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &stats_in Hands over the precomputed subsequence statistics.
+  ///\param [in] k_in Hands over the number of pair motifs.
+  ///\param [out] &pos0_out Returns the positions of the first subsequences.
+  ///\param [out] &pos1_out Returns the positions of the second subsequences.
+  ///\param [out] &d_out Returns the distances of the pair motifs.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  void tpmTopK(const rseq &timeSeries_in, const SubsequenceStats &stats_in,
+      const int k_in, iseq &pos0_out, iseq &pos1_out, rseq &d_out, const int
+      threads_in = 1);
+
+  ///\brief The single precision top pair motif dicovery procedure.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &sums_in Hands over the running sum.
+  ///\param [in] &sumSquares_in Hands over the running sum of squares.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///\return The distance of the top pair motif in double precision.
+  ///
+  ///This is the single precision version of the top pair motif discovery
+  ///algorithm. The time series is centered by its mean c and converted to
+  ///float, which doubles the SIMD width and halves the memory traffic. The
+  ///dot products are recomputed from scratch every 256 rows of a diagonal,
+  ///i.e., the drift of the iterative update does not grow with the length of
+  ///the time series. Each such chunk subtracts the means of its first
+  ///subsequences as anchors, i.e., the dot products scale with the local
+  ///deviation of the values. The distance of the returned pair is recomputed
+  ///in double precision.
+  ///
+  ///Let u = 2^-24, M = max|x - c| and E the largest deviation of the 256 +
+  ///window values of a chunk from their anchor. To first order in u, the
+  ///absolute error of a squared distance is at most
+  ///2 * u * (window + 256) * E * (2 * window * E + 12 * M + 12 * E)
+  ///* rSigma_i * rSigma_j + 16 * u * window. The error grows with M only
+  ///linearly and with a small factor, e.g., M is about 130 and E at most 55
+  ///for a random walk of 20000 values with unit steps and window 100. The
+  ///returned pair differs from the pair of tpm() only if both distances are
+  ///closer than the error, the returned distance is never smaller than the
+  ///one of tpm() up to double rounding. Use the double precision version if
+  ///the top pair motif has to be certified.
+  double tpmFloat(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, int &pos0_out, int &pos1_out, const int window_in,
+      const int threads_in = 1);
+
+  ///\brief The single precision top pair motif dicovery procedure on
+  ///precomputed statistics.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &stats_in Hands over the precomputed subsequence statistics.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///\return The distance of the top pair motif in double precision.
+  double tpmFloat(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, int &pos0_out, int &pos1_out, const int threads_in = 1);
+
+  ///\brief The single precision running sums procedure.
+  ///
+  ///\param [in] &timeSeries_in Hands over the time series.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [out] &sums_out Returns the running sum.
+  ///\param [out] &sumSquares_out Returns the running sum of squares.
+  ///
+  ///This procedure computes the running sum and sum of squares in single
+  ///precision. The sums are recomputed from scratch every 256 subsequences,
+  ///hence the absolute error is bounded by about (window + 512) * 2^-24 *
+  ///max|x|^2 for the sum of squares. The variance derived from them cancels
+  ///if the mean is large compared to the standard deviation, hence the time
+  ///series should be centered.
+  void runningsFloat(const fseq &timeSeries_in, const int window_in, fseq
+      &sums_out, fseq &sumSquares_out);
+
+  ///\brief The single precision similarity procedure.
+  ///
+  ///\param [in] &timeSeries_in Hands over the time series.
+  ///\param [in] &sums_in Hands over the running sum.
+  ///\param [in] &sumSquares_in Hands over the running sum of squares.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] pos0_in Hands over the position of the first subsequence.
+  ///\param [in] pos1_in Hands over the position of the second subsequence.
+  ///\param [in] bestSoFar_in Hands over the best so far distance for early
+  ///abandoning.
+  ///
+  ///\return The z-normalized Euclidean distance of the subsequences.
+  ///
+  ///This is the single precision version of the similarity function of the
+  ///TSGenerator. Standard deviations smaller than 1 are replaced by 1 as in
+  ///the double precision version.
+  float similarityFloat(const fseq &timeSeries_in, const fseq &sums_in, const
+      fseq &sumSquares_in, const int window_in, const int pos0_in, const int
+      pos1_in, const float bestSoFar_in = std::numeric_limits<float>::max());
+
+  ///\brief The matrix profile procedure.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &sums_in Hands over the running sum.
+  ///\param [in] &sumSquares_in Hands over the running sum of squares.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] exclusion_in Hands over the exclusion zone, i.e., two
+  ///subsequences are trivial matches if the absolute difference of their
+  ///positions is smaller than exclusion_in.
+  ///\param [out] &profile_out Returns the z-normalized Euclidean distance of
+  ///each subsequence to its nearest non-trivial neighbor.
+  ///\param [out] &index_out Returns the position of the nearest non-trivial
+  ///neighbor of each subsequence or -1 if there is none.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///This algorithm computes the self-join matrix profile and profile index of
+  ///a time series. It evaluates the diagonals of the distance matrix like the
+  ///top pair motif discovery and keeps the row and column minima of each
+  ///diagonal, i.e., each distance is computed only once. Ties are broken by
+  ///the smaller position, hence the diagonals are traversed in cache-sized
+  ///tiles independent of the order of the distances.
+  void matrixProfile(const rseq &timeSeries_in, const rseq &sums_in, const
+      rseq &sumSquares_in, const int window_in, const int exclusion_in, rseq
+      &profile_out, iseq &index_out, const int threads_in = 1);
+
+  ///\brief The matrix profile procedure on precomputed statistics.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &stats_in Hands over the precomputed subsequence statistics.
+  ///\param [in] exclusion_in Hands over the exclusion zone.
+  ///\param [out] &profile_out Returns the matrix profile.
+  ///\param [out] &index_out Returns the profile index.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  void matrixProfile(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, const int exclusion_in, rseq &profile_out, iseq &index_out,
+      const int threads_in = 1);
+
+  ///\brief The squared matrix profile procedure on precomputed statistics.
+  ///
+  ///\param [in] &timeSeries Hands over the time series.
+  ///\param [in] &stats_in Hands over the precomputed subsequence statistics.
+  ///\param [in] exclusion_in Hands over the exclusion zone.
+  ///\param [out] &profile_out Returns the squared z-normalized Euclidean
+  ///distance of each subsequence to its nearest non-trivial neighbor.
+  ///\param [out] &index_out Returns the profile index.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///This is the matrix profile procedure without the final square root, the
+  ///squared distances are clamped to be non-negative.
+  void squaredMatrixProfile(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, const int exclusion_in, rseq &profile_out, iseq &index_out,
+      const int threads_in = 1);
 }
 
 #endif
@@ -19,9 +19,20 @@
 #include <cfloat>
 #include <limits>
 #include <iterator>
+#include <optional>
+#include <thread>
+#include <atomic>
+#include <functional>
 #include <tsgtypes.hpp>
 #include <motifsetcollection.hpp>
 #include <freepositions.hpp>
+#include <matrixprofile.hpp>
+#include <runningstats.hpp>
+#include <subsequencestats.hpp>
+#include <distanceprofile.hpp>
+#include <distancerowcache.hpp>
+#include <distancekernel.hpp>
+#include <threadpool.hpp>
 #include <basets.hpp>
 #include <tpm.hpp>
 #include <tsm.hpp>
@@ -176,12 +187,85 @@ namespace tsg
     ///series. Is ignored in the case of pair motif injection.
     int smaller = 1;
 
+    ///\brief This variable contains the number of threads.
+    ///
+    ///This variable stores the number of threads used by the parallel
+    ///algorithms. A value smaller than 1 uses all hardware threads.
+    int threads = 0;
+
+    ///\brief This variable contains the number of speculative candidates.
+    ///
+    ///This variable stores the number of candidate positions the inject
+    ///routines draw and verify concurrently per round. A value of 1 tries one
+    ///position after another.
+    int speculation = 1;
+
+    ///\brief This variable contains the number of lower bound segments.
+    ///
+    ///This variable stores the number of segments of the piecewise aggregate
+    ///approximation that bounds the similarities of the motif checks. A value
+    ///smaller than 1 disables the lower bound.
+    int segments = 8;
+
+    ///\brief This variable counts the lower bound checks.
+    ///
+    ///This variable stores the number of similarities of the motif checks
+    ///since the last base time series was generated.
+    std::atomic<long> boundChecks{0};
+
+    ///\brief This variable counts the pruned similarities.
+    ///
+    ///This variable stores the number of similarities of the motif checks
+    ///skipped by the lower bound.
+    std::atomic<long> boundPrunes{0};
+
+    ///\brief This variable contains the top pair motif gap.
+    ///
+    ///This variable stores the distance between the top pair motif and the
+    ///second pair motif of tpmTopK() of the last generated time series, i.e.,
+    ///how clearly the top pair motif is separated from the best pair not
+    ///overlapping it.
+    double topPairGap = std::numeric_limits<double>::infinity();
+
+    ///\brief This variable contains the certification flag.
+    ///
+    ///This variable stores whether run() certifies the ground truth of the
+    ///generated time series with an exact range motif search.
+    bool certification = false;
+
+    ///\brief This variable contains the certificate of the last run.
+    ///
+    ///This variable stores the certificate of the last generated time series
+    ///if the certification is enabled.
+    certificate lastCertificate;
+
+    ///\brief This variable contains the time budget of the estimates.
+    ///
+    ///This variable stores the time budget in seconds of the anytime top pair
+    ///motif discovery used for the intermediate estimates. A value smaller
+    ///than or equal to 0 disables the time budget.
+    double budgetSeconds = 0.0;
+
+    ///\brief This variable contains the diagonal budget of the estimates.
+    ///
+    ///This variable stores the number of diagonals evaluated by the anytime
+    ///top pair motif discovery used for the intermediate estimates. A value
+    ///smaller than 1 disables the diagonal budget.
+    int budgetDiagonals = 0;
+
     ///\brief This variable contains the free positions.
     ///
     ///This variable stores the positions of free subsequences in the time
     ///series between the motif sets subsequences.
     FreePositions freePositions;
 
+    ///\brief This variable contains the matrix profile.
+    ///
+    ///This variable stores the nearest neighbor of each subsequence of the
+    ///time series. It is refreshed incrementally after each edit of the time
+    ///series and provides the top pair motif.
+    MatrixProfile matrixProfile;
+
     ///\brief This variable stores a custom shape.
     ///
     ///This variable stores the values of a custom shape defined by the user.
@@ -200,6 +284,13 @@ namespace tsg
     ///generate matching subsequences.
     rseq zMotif;
 
+    ///\brief This variable stores the visiting order of the z-normalized motif.
+    ///
+    ///This variable stores the offsets of the z-normalized motif sorted by
+    ///their absolute values in descending order. The comparisons with the
+    ///motif visit the values in this order to abandon early.
+    iseq motifOrder;
+
     ///\brief This variable stores the random engine.
     ///
     ///The pseudo random engine generates random numbers with the Mersene
@@ -222,13 +313,61 @@ namespace tsg
     ///This variable stores the running sum of squares of the time series.
     rseq sumSquares;
 
+    ///\brief Compensated running statistics.
+    ///
+    ///This variable stores the shifted and compensated running sums of the
+    ///time series, which the running sums and the subsequence statistics are
+    ///derived from.
+    RunningStats runnings;
+
+    ///\brief Subsequence statistics.
+    ///
+    ///This variable stores the mean and inverse standard deviation of all
+    ///subsequences of the time series. It is updated next to the running sums
+    ///and handed over to all distance kernels.
+    SubsequenceStats stats;
+
+    ///\brief This variable contains the distance row cache.
+    ///
+    ///This variable stores the similarity rows of the motif set checks. The
+    ///rows are reused across retries and motif sets, an edit of the time
+    ///series only invalidates the entries it touches.
+    DistanceRowCache rowCache;
+
+    ///\brief This variable contains the speculative views.
+    ///
+    ///This variable stores one private copy of the time series per
+    ///speculative worker. The views are allocated once per run, afterwards
+    ///only the windows edited since the last round are synchronized.
+    rseqs views;
+
+    ///\brief This variable contains the running statistics of the views.
+    std::vector<RunningStats> viewRunnings;
+
+    ///\brief This variable contains the running sums of the views.
+    rseqs viewSums;
+
+    ///\brief This variable contains the running sums of squares of the views.
+    rseqs viewSumSquares;
+
+    ///\brief This variable contains the subsequence statistics of the views.
+    std::vector<SubsequenceStats> viewStats;
+
+    ///\brief This variable contains the edits not synchronized to the views.
+    ///
+    ///This variable stores the positions of the windows of the time series
+    ///edited since the views were synchronized last.
+    iseq viewEdits;
+
 
     ///\brief Calculates the running sum and sum of squares of a sequence.
     ///
     ///\param [in] &sequence_in Hands over the sequence.
     ///
     ///This function computes the running sum and sum of squares of a time
-    ///series.
+    ///series from the compensated running statistics, which are recomputed
+    ///exactly at each block, i.e., the statistics stay accurate for long time
+    ///series with large offsets.
     void calcRunnings(const rseq &sequence_in);
 
     ///\brief Update the running sum and sum of squares of a sequence.
@@ -237,9 +376,61 @@ namespace tsg
     ///\param [in] pos_in Hands over the position of the injected subsequence.
     ///
     ///This function updates the running sum and sum of squares of a sequence at
-    ///a specific location.
+    ///a specific location in O(window).
     void updateRunnings(const rseq &timeSeries_in, const int pos_in);
 
+    ///\brief Update given running sums and statistics of a sequence.
+    ///
+    ///\param [in] &sequence_in Hands over the sequence.
+    ///\param [in] pos_in Hands over the position of the injected subsequence.
+    ///\param [in,out] &runnings_inout Hands over and returns the compensated
+    ///running statistics.
+    ///\param [in,out] &sums_inout Hands over and returns the running sum.
+    ///\param [in,out] &sumSquares_inout Hands over and returns the running sum
+    ///of squares.
+    ///\param [in,out] &stats_inout Hands over and returns the subsequence
+    ///statistics.
+    ///
+    ///This function updates a copy of the runnings, e.g., the ones of a
+    ///speculative view of the time series.
+    void updateRunnings(const rseq &sequence_in, const int pos_in,
+        RunningStats &runnings_inout, rseq &sums_inout, rseq
+        &sumSquares_inout, SubsequenceStats &stats_inout) const;
+
+    ///\brief Synchronizes a window of a view with the time series.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] view_in Hands over the index of the view.
+    ///\param [in] pos_in Hands over the position of the window.
+    ///
+    ///This function copies the window and the runnings and statistics it
+    ///touches from the time series to the view in O(window).
+    void syncView(const rseq &timeSeries_in, const int view_in, const int
+        pos_in);
+
+    ///\brief Synchronizes the views with the time series.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] workers_in Hands over the number of views.
+    ///
+    ///This function allocates the views on first use in a run and otherwise
+    ///synchronizes the windows edited since the last call, or copies the whole
+    ///time series if that is cheaper.
+    void syncViews(const rseq &timeSeries_in, const int workers_in);
+
+    ///\brief Estimates the top pair motif of the time series.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [out] &pos0_out Returns the position of the first subsequence.
+    ///\param [out] &pos1_out Returns the position of the second subsequence.
+    ///
+    ///This function computes the top pair motif with the incrementally
+    ///maintained matrix profile. If a budget is set, the anytime top pair
+    ///motif discovery is used instead and the pair is only an estimate, i.e.,
+    ///its distance is an upper bound of the top pair motif distance.
+    void estimateTopPair(const rseq &timeSeries_in, int &pos0_out, int
+        &pos1_out);
+
     ///\brief Computes a custom sequence from the shape vector.
     ///
     ///\param [in] &sequence_out Hands over the sequence.
@@ -265,6 +456,118 @@ namespace tsg
         pos1_in, const double bestSoFar_in
         = std::numeric_limits<double>::max());
 
+    ///\brief Computes the similarity of two subsequences in a sequence.
+    ///
+    ///\param [in] &sequence_in Hands over the sequence.
+    ///\param [in] &stats_in Hands over the subsequence statistics of the
+    ///sequence.
+    ///\param [in] pos0_in Hands over the position of the first subsequence.
+    ///\param [in] pos1_in Hands over the position of the second subsequence.
+    ///\param [in] bestSoFar_in Hands over the best similarity so far.
+    ///
+    ///\return The similarity of the two z-normalized subsequences.
+    ///
+    ///This function computes the similarity with the given statistics instead
+    ///of the ones of the generator.
+    double similarity(const rseq &sequence_in, const SubsequenceStats
+        &stats_in, const int pos0_in, const int pos1_in, const double
+        bestSoFar_in = std::numeric_limits<double>::max());
+
+    ///\brief Z-normalizes a subsequence and computes its visiting order.
+    ///
+    ///\param [in] &sequence_in Hands over the sequence.
+    ///\param [in] &stats_in Hands over the subsequence statistics of the
+    ///sequence.
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [out] &zSequence_out Returns the z-normalized subsequence.
+    ///\param [out] &order_out Returns the visiting order.
+    ///
+    ///This function sorts the offsets of the subsequence by their absolute
+    ///z-normalized values in descending order. The largest values contribute
+    ///the most to the distance on average, hence, early abandoning in this
+    ///order stops after fewer values.
+    void visitingOrder(const rseq &sequence_in, const SubsequenceStats
+        &stats_in, const int pos_in, rseq &zSequence_out, iseq &order_out)
+      const;
+
+    ///\brief Computes the visiting order of a z-normalized subsequence.
+    ///
+    ///\param [in] &zSequence_in Hands over the z-normalized subsequence.
+    ///\param [out] &order_out Returns the visiting order.
+    ///
+    ///This function sorts the offsets by their absolute values in descending
+    ///order, e.g., for the z-normalized motif.
+    void visitingOrder(const rseq &zSequence_in, iseq &order_out) const;
+
+    ///\brief Computes the similarity of a fixed z-normalized sequence and a
+    ///subsequence.
+    ///
+    ///\param [in] &sequence_in Hands over the sequence.
+    ///\param [in] &stats_in Hands over the subsequence statistics of the
+    ///sequence.
+    ///\param [in] &zSequence_in Hands over the fixed z-normalized sequence.
+    ///\param [in] &order_in Hands over the visiting order of the fixed
+    ///sequence.
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [in] bestSoFar_in Hands over the best similarity so far.
+    ///
+    ///\return The similarity of the z-normalized sequences.
+    ///
+    ///This function visits the values in the given order and abandons the
+    ///computation as soon as the best similarity so far is exceeded.
+    double similarity(const rseq &sequence_in, const SubsequenceStats
+        &stats_in, const rseq &zSequence_in, const iseq &order_in, const int
+        pos_in, const double bestSoFar_in) const;
+
+    ///\brief Computes the similarity of two subsequences within a range.
+    ///
+    ///\param [in] &sequence_in Hands over the sequence.
+    ///\param [in] &stats_in Hands over the subsequence statistics of the
+    ///sequence.
+    ///\param [in] pos0_in Hands over the position of the first subsequence.
+    ///\param [in] pos1_in Hands over the position of the second subsequence.
+    ///\param [in] range_in Hands over the range.
+    ///\param [in,out] &checks_inout Hands over and returns the number of
+    ///checked pairs.
+    ///\param [in,out] &prunes_inout Hands over and returns the number of
+    ///pruned pairs.
+    ///
+    ///\return The early abandoned similarity, i.e., the similarity if it is
+    ///within range and a value larger than the range otherwise.
+    ///
+    ///This function skips the similarity if the lower bound of the
+    ///statistics exceeds the range.
+    double prunedSimilarity(const rseq &sequence_in, const SubsequenceStats
+        &stats_in, const int pos0_in, const int pos1_in, const double range_in,
+        long &checks_inout, long &prunes_inout);
+
+    ///\brief Computes the similarity of a fixed subsequence and subsequences
+    ///within a range.
+    ///
+    ///\param [in] &sequence_in Hands over the sequence.
+    ///\param [in] &stats_in Hands over the subsequence statistics of the
+    ///sequence.
+    ///\param [in] pos0_in Hands over the position of the fixed subsequence.
+    ///\param [in] &zSequence0_in Hands over the z-normalized fixed
+    ///subsequence.
+    ///\param [in] &order0_in Hands over the visiting order of the fixed
+    ///subsequence.
+    ///\param [in] pos1_in Hands over the position of the second subsequence.
+    ///\param [in] range_in Hands over the range.
+    ///\param [in,out] &checks_inout Hands over and returns the number of
+    ///checked pairs.
+    ///\param [in,out] &prunes_inout Hands over and returns the number of
+    ///pruned pairs.
+    ///
+    ///\return The early abandoned similarity.
+    ///
+    ///This function is the variant of the function above for the rows of
+    ///the verification, in which one subsequence is compared to many.
+    double prunedSimilarity(const rseq &sequence_in, const SubsequenceStats
+        &stats_in, const int pos0_in, const rseq &zSequence0_in, const iseq
+        &order0_in, const int pos1_in, const double range_in, long
+        &checks_inout, long &prunes_inout);
+
     ///\brief Computes the mean and standard deviation of a sequence.
     ///
     ///\param [in] &sequence_in Hands over the sequence.
@@ -288,7 +591,8 @@ namespace tsg
     ///a subsequence of the time series, and a subsequence. Therefore, the
     ///sequence and subsequence are first z-normalized and the Euclidean
     ///Distance is computed. The return value is the similarity of the
-    ///z-normalized sequences.
+    ///z-normalized sequences. The values are visited in the order of the
+    ///largest absolute z-normalized motif values.
     double similarityWithMotif(const rseq &timeSeries_in, const int pos_in,
         const double bestSoFar_in);
 
@@ -324,6 +628,23 @@ namespace tsg
     bool smallerDistance(const rseq &timeSeries_in, const iseq
         &motifPositions_in, const double similarity_in);
 
+    ///\brief Check if there is a better pair motif in the time series.
+    ///
+    ///\param [in] &timeSereis_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics of the time
+    ///series.
+    ///\param [in] &subsequencePositions_in Hands over the pair motif
+    ///subsequence positions.
+    ///\param [in] similarity_in Hands over the similarity to break.
+    ///
+    ///\return true if there exists a subsequence pair in the time series with
+    ///smaller distance.
+    ///
+    ///This function checks the time series with the given statistics instead
+    ///of the ones of the generator.
+    bool smallerDistance(const rseq &timeSeries_in, const SubsequenceStats
+        &stats_in, const iseq &motifPositions_in, const double similarity_in);
+
     ///\brief Checks if there is a larger motif set.
     ///
     ///\param [in] &timeSereis_in Hands over the time series.
@@ -335,19 +656,210 @@ namespace tsg
     ///motifPositions_in.back().
     ///
     ///This function computes the largest set motif size for a given
-    ///subsequence.
+    ///subsequence. Both the collection of the matches and the set motif
+    ///checks run in parallel on contiguous blocks of candidates.
     int largerMotifSet(const rseq &timeSeries_in, const int pos_in, const int
         size_in, const double range_in);
 
+    ///\brief Checks if there is a larger motif set.
+    ///
+    ///\param [in] &timeSereis_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics of the time
+    ///series.
+    ///\param [in] &pos_in Hands over the position of the new subsequence.
+    ///\param [in] size_in Hands over the size of the injected motif.
+    ///\param [in] range_in Hands over the motif set range.
+    ///\param [in] threads_in Hands over the number of threads.
+    ///
+    ///\return Size of the first largest set motif for the subsequence
+    ///motifPositions_in.back().
+    ///
+    ///This function checks the time series with the given statistics and
+    ///number of threads instead of the ones of the generator.
+    int largerMotifSet(const rseq &timeSeries_in, const SubsequenceStats
+        &stats_in, const int pos_in, const int size_in, const double range_in,
+        const int threads_in);
+
+    ///\brief Collects the matches of consecutive subsequences.
+    ///
+    ///\param [in] &timeSereis_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics.
+    ///\param [in] start_in Hands over the first subsequence.
+    ///\param [in] end_in Hands over the subsequence behind the last one.
+    ///\param [in] range_in Hands over the motif set range.
+    ///\param [in] *cache_in Hands over the distance row cache or nullptr.
+    ///\param [out] &matches_out Returns the positions of all subsequences
+    ///within range of one of the subsequences, unsorted and with duplicates.
+    ///
+    ///This function is the first phase of largerMotifSet() for one block of
+    ///candidates.
+    void collectMatches(const rseq &timeSeries_in, const SubsequenceStats
+        &stats_in, const int start_in, const int end_in, const double range_in,
+        DistanceRowCache *cache_in, iseq &matches_out);
+
+    ///\brief Computes the largest set motif of some matches.
+    ///
+    ///\param [in] &timeSereis_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics.
+    ///\param [in] &matches_in Hands over the sorted matches.
+    ///\param [in] begin_in Hands over the index of the first match.
+    ///\param [in] end_in Hands over the index behind the last match.
+    ///\param [in] size_in Hands over the size of the injected motif.
+    ///\param [in] range_in Hands over the motif set range.
+    ///\param [in] *cache_in Hands over the distance row cache or nullptr.
+    ///\param [in,out] &larger_inout Hands over and returns the flag whether a
+    ///larger set motif was found by any block.
+    ///
+    ///\return The size of the largest set motif of the matches.
+    ///
+    ///This function is the second phase of largerMotifSet() for one block of
+    ///matches. It stops as soon as a set motif larger than size_in is found
+    ///or the flag is set by another block.
+    int largestSet(const rseq &timeSeries_in, const SubsequenceStats
+        &stats_in, const iseq &matches_in, const int begin_in, const int
+        end_in, const int size_in, const double range_in, DistanceRowCache
+        *cache_in, std::atomic<bool> &larger_inout);
+
+    ///\brief Computes the set motif sizes of consecutive subsequences.
+    ///
+    ///\param [in] &timeSereis_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics.
+    ///\param [in] start_in Hands over the first subsequence.
+    ///\param [in] end_in Hands over the subsequence behind the last one.
+    ///\param [in] range_in Hands over the motif set range.
+    ///\param [out] &sizes_out Returns the set motif size of each subsequence
+    ///of the block.
+    ///
+    ///This function computes for each subsequence of the block the number of
+    ///non overlapping subsequences within range of it, including itself. The
+    ///distance profiles of the consecutive subsequences are swept, i.e., the
+    ///sizes are exact.
+    void setSizes(const rseq &timeSeries_in, const SubsequenceStats &stats_in,
+        const int start_in, const int end_in, const double range_in, iseq
+        &sizes_out);
+
+    ///\brief Certifies the ground truth of a time series.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics.
+    ///\param [in] &d_in Hands over the range of each of the motif sets.
+    ///\param [in] &pos_in Hands over the positions of each motif set.
+    ///\param [in] tolerance_in Hands over the relative slack of the range.
+    ///
+    ///\return The certificate of the time series.
+    ///
+    ///This function certifies with the given statistics, i.e., run() uses
+    ///the statistics the ranges were computed with.
+    certificate certify(const rseq &timeSeries_in, const SubsequenceStats
+        &stats_in, const rseq &d_in, const iseqs &pos_in, const double
+        tolerance_in);
+
+    ///\brief Provides the similarities of a subsequence to all subsequences.
+    ///
+    ///\param [in] &timeSereis_in Hands over the time series.
+    ///\param [in] &stats_in Hands over the subsequence statistics.
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [in] range_in Hands over the range of the similarities.
+    ///\param [in] *distanceProfile_in Hands over the distance profile to
+    ///filter the similarities or nullptr.
+    ///\param [in,out] &profile_inout Hands over the buffer of the distance
+    ///profile.
+    ///\param [in] *cache_in Hands over the distance row cache or nullptr.
+    ///\param [out] &row_out Returns the row of early abandoned similarities,
+    ///i.e., each value is exact if it is within range, larger than the range
+    ///otherwise and negative if it is not computed yet.
+    ///
+    ///This function takes the row from the cache. Otherwise a new row is
+    ///inserted into the cache. With a distance profile the few subsequences
+    ///passing its filter are computed and all others are larger than the
+    ///range. Without, all similarities are unknown, the callers compute them
+    ///on first use and store them in the row, i.e., the row is completed
+    ///lazily across calls.
+    void distanceRow(const rseq &timeSeries_in, const SubsequenceStats
+        &stats_in, const int pos_in, const double range_in, DistanceProfile
+        *distanceProfile_in, rseq &profile_inout, DistanceRowCache *cache_in,
+        std::shared_ptr<rseq> &row_out);
+
+    ///\brief Computes the offset of a subsequence to inject.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] pos_in Hands over the position of the subsequence.
+    ///\param [in] &subsequence_in Hands over the subsequence to inject.
+    ///\param [in] clamp_in Hands over a flag whether to keep the injected
+    ///subsequence within maxi.
+    ///
+    ///\return The value added to each value of the subsequence.
+    ///
+    ///This function aligns the subsequence to the mean of the first and last
+    ///value it replaces.
+    double injectionOffset(const rseq &timeSeries_in, const int pos_in, const
+        rseq &subsequence_in, const bool clamp_in) const;
+
+    ///\brief Injects a subsequence at a verified random position.
+    ///
+    ///\param [in,out] &timeSeries_inout Hands over the time series and
+    ///returns it with the injected subsequence.
+    ///\param [in] &subsequence_in Hands over the subsequence to inject.
+    ///\param [in] clamp_in Hands over a flag whether to keep the injected
+    ///subsequence within maxi.
+    ///\param [in] retries_in Hands over the number of positions to try.
+    ///\param [in] &accept_in Hands over the verification, which gets the time
+    ///series, its statistics, the position and the number of threads.
+    ///
+    ///\return The position of the injected subsequence or -1 if no position
+    ///passed the verification.
+    ///
+    ///This function draws random positions from the free positions and
+    ///injects the subsequence at the first one passing the verification. The
+    ///position is not removed from the free positions. With a speculation
+    ///larger than 1 the candidates of each round are drawn as a batch of
+    ///non-overlapping positions, verified concurrently on the views of the
+    ///time series and the runnings, and the first passing candidate in
+    ///drawing order is committed. Since the number of
+    ///drawn candidates does not depend on the verification order, the result
+    ///is the same for any number of threads.
+    int injectSubsequence(rseq &timeSeries_inout, const rseq &subsequence_in,
+        const bool clamp_in, const int retries_in, const std::function<bool(
+          const rseq &, const SubsequenceStats &, const int, const int)>
+        &accept_in);
+
     ///\brief Generate a Match.
     ///
     ///\param [in] range_in Hands over the motif range.
     ///\param [out] &match_out Returns the match.
     ///
     ///This function computes a non z-normalized motif match based on the
-    ///z-normalized motif zmotif.
+    ///z-normalized motif zmotif. The window sizes of dispatchWindow use
+    ///specialized versions.
     void generateMatch(const double range_in, rseq &match_out);
 
+    ///\brief Generate the Matches of a motif set.
+    ///
+    ///\param [in] range_in Hands over the motif range.
+    ///\param [in] count_in Hands over the number of matches.
+    ///\param [out] &matches_out Returns the matches.
+    ///
+    ///This function computes count_in matches like generateMatch, but
+    ///dispatches the window size once and reuses the buffers for all matches.
+    void generateMatches(const double range_in, const int count_in, rseqs
+        &matches_out);
+
+    ///\brief Generate a Match for a window size.
+    ///
+    ///\param [in] range_in Hands over the motif range.
+    ///\param [out] &match_out Returns the match.
+    ///\param [in,out] &offsets_inout Hands over a buffer for the shuffled
+    ///offsets.
+    ///
+    ///This function is the body of generateMatch. A positive fixedWindow
+    ///replaces the window size by a compile-time constant. The match keeps
+    ///running sums of its values, its squared values and its products with
+    ///zMotif, such that each perturbation is checked in constant time. The
+    ///shifts of the mean are accumulated and applied once at the end.
+    template <int fixedWindow>
+    void generateMatchKernel(const double range_in, rseq &match_out, iseq
+        &offsets_inout);
+
     ///\brief Mean to 0 and store motif as well as Z-normalize and store motif.
     ///
     ///\param [in] &motif_in Hands over the motif sequence.
@@ -523,6 +1035,129 @@ namespace tsg
     ///The destructor does actually nothing.
     ~TSGenerator();
 
+    ///\brief Sets the number of threads.
+    ///
+    ///\param [in] threads_in Hands over the number of threads.
+    ///
+    ///This function sets the number of threads used by the parallel
+    ///algorithms. A value smaller than 1 uses all hardware threads.
+    void setThreads(const int threads_in);
+
+    ///\brief Sets the number of speculative candidates.
+    ///
+    ///\param [in] speculation_in Hands over the number of candidates.
+    ///
+    ///This function sets the number of candidate positions the inject
+    ///routines verify concurrently per round. Larger values cut the latency
+    ///of configurations where most positions fail, but consume more random
+    ///positions. The generated time series depends on the speculation, but
+    ///not on the number of threads.
+    void setSpeculation(const int speculation_in);
+
+    ///\brief Seeds the random engines.
+    ///
+    ///\param [in] seed_in Hands over the seed.
+    ///
+    ///This function seeds the random engines of the generator, the base time
+    ///series and the free positions, i.e., the generated time series is
+    ///reproducible.
+    void setSeed(const unsigned int seed_in);
+
+    ///\brief Sets the lower bound of the motif checks.
+    ///
+    ///\param [in] segments_in Hands over the number of segments.
+    ///
+    ///This function sets the number of segments of the piecewise aggregate
+    ///approximation whose distance bounds the similarities of the motif
+    ///checks from below. A value smaller than 1 disables the lower bound.
+    ///The setting takes effect with the next generated time series.
+    void setLowerBound(const int segments_in);
+
+    ///\brief Returns the pruning rate of the lower bound.
+    ///
+    ///\return The fraction of the similarities of the motif checks skipped
+    ///by the lower bound during the last run.
+    double getPruningRate() const;
+
+    ///\brief Sets the capacity of the distance row cache.
+    ///
+    ///\param [in] bytes_in Hands over the capacity in bytes.
+    ///
+    ///This function limits the memory of the cached similarity rows of the
+    ///motif set checks. A capacity of 0 disables the cache.
+    void setRowCache(const std::size_t bytes_in);
+
+    ///\brief Returns the distance row cache hits.
+    ///
+    ///\return The number of similarity rows taken from the cache during the
+    ///last run.
+    long getRowCacheHits() const;
+
+    ///\brief Returns the distance row cache misses.
+    ///
+    ///\return The number of similarity rows computed during the last run.
+    long getRowCacheMisses() const;
+
+    ///\brief Returns the top pair motif gap.
+    ///
+    ///\return The distance between the top pair motif and the second pair
+    ///motif of tpmTopK() of the last generated time series or infinity if
+    ///there is no second pair.
+    double getTopPairGap() const;
+
+    ///\brief Enables the certification of the ground truth.
+    ///
+    ///\param [in] certification_in Hands over the certification flag.
+    ///
+    ///This function enables or disables the certification stage of run(),
+    ///which certifies the ground truth of each generated time series, see
+    ///certify().
+    void setCertification(const bool certification_in);
+
+    ///\brief Returns the certificate of the last run.
+    ///
+    ///\return The certificate of the last generated time series. The
+    ///certificate is empty if the certification is disabled.
+    const certificate &getCertificate() const;
+
+    ///\brief Certifies the ground truth of a time series.
+    ///
+    ///\param [in] &timeSeries_in Hands over the time series.
+    ///\param [in] &d_in Hands over the range of each of the motif sets.
+    ///\param [in] &pos_in Hands over the positions of each motif set.
+    ///\param [in] tolerance_in Hands over the relative slack of the range.
+    ///
+    ///\return The certificate of the time series.
+    ///
+    ///This function runs an exact range motif search over the time series,
+    ///split into contiguous blocks of subsequences, one per thread. The range
+    ///is the one the inject routine verified, i.e., the range of the motif
+    ///set and twice the range for latent motifs, widened by the tolerance,
+    ///since the ranges are the exact similarities of the injected
+    ///subsequences and recomputed statistics differ in rounding. The
+    ///injected motif is confirmed if an injected subsequence is the center of
+    ///the largest set motif, the largest set motif has the size of the
+    ///injected motif and all set motifs not overlapping it are smaller. The
+    ///statistics are computed locally, i.e., the statistics, caches and
+    ///counters of the generator are not changed. The outputs of run() with
+    ///the settings of the generator are expected.
+    certificate certify(const rseq &timeSeries_in, const rseq &d_in, const
+        iseqs &pos_in, const double tolerance_in = defaultTolerance);
+
+    ///\brief Sets the budget of the intermediate top pair motif estimates.
+    ///
+    ///\param [in] seconds_in Hands over the time budget in seconds.
+    ///\param [in] diagonals_in Hands over the diagonal budget.
+    ///
+    ///This function enables the anytime top pair motif discovery for the
+    ///intermediate estimates in the inject routines. A value smaller than or
+    ///equal to 0 disables the corresponding budget, if both are disabled the
+    ///exact matrix profile is used. The top pair motif reported by run() is
+    ///always exact. Seeded runs are reproducible with the diagonal budget
+    ///alone, with a time budget the estimates and hence the generated time
+    ///series depend on the timing.
+    void setBudget(const double seconds_in, const int diagonals_in);
+
     ///\brief Generates a time series with defined time series motif sets.
     ///
     ///\param [out] &timeSeries_out Hands over the time series.
@@ -10,6 +10,7 @@
 #include <vector>
 #include <set>
 #include <string>
+#include <complex>
 
 
 namespace tsg {
@@ -20,6 +21,18 @@ namespace tsg {
   ///a sequence of reals.
   typedef std::vector<double> rseq;
 
+  ///\brief This is a vector of single precision reals.
+  ///
+  ///The vector of single precision reals is used by the single precision
+  ///kernels, which trade accuracy for twice the SIMD width.
+  typedef std::vector<float> fseq;
+
+  ///\brief This is a vector of complex numbers.
+  ///
+  ///The vector of complex numbers is used as the spectrum of a sequence of
+  ///reals by the fast Fourier transform.
+  typedef std::vector<std::complex<double>> cseq;
+
   ///\brief This is a vector of vectors of reals.
   ///
   ///The vector of vectors of reals is used as a mathimatical matrix of reals
@@ -38,6 +51,12 @@ namespace tsg {
   ///integers or a sequence of sequences of integers.
   typedef std::vector<std::vector<int>> iseqs;
 
+  ///\brief This is a vector of counts.
+  ///
+  ///The vector of counts is used for large counts like the number of pairs of
+  ///subsequences of a time series.
+  typedef std::vector<long long> lseq;
+
   ///\brief This is a set of unique integers.
   ///
   ///The set of unique integers contains integers without duplicates.
@@ -86,6 +105,25 @@ namespace tsg {
   ///The interval sequence is a seuqence of intervals.
   typedef std::vector<interval> intervals;
 
+  ///\brief This struct represents a certificate of the ground truth.
+  ///
+  ///The certificate consists of the results of an exact range motif search
+  ///over a generated time series, i.e., the size and center of the largest
+  ///set motif at the range of the injected motif, the size of the largest set
+  ///motif not overlapping it, their difference and whether the injected
+  ///motif is confirmed as the unique largest one. The center is an injected
+  ///subsequence if one of them is the center of a largest set motif.
+  struct certificate {
+
+    double range = 0.0;
+    int largest = 0;
+    int center = -1;
+    int runnerUp = 0;
+    int margin = 0;
+    bool confirmed = false;
+    double seconds = 0.0;
+  };
+
   ///\brief This is the default time series length default.
   ///
   ///The default time series length sets the default number of values of the
@@ -163,6 +201,19 @@ namespace tsg {
   ///The default generator sets the default injection procedure like pair
   ///motif, set motif or latent motif injection.
   const word defaultGen = "latent motif";
+
+  ///\brief This is the default row cache capacity.
+  ///
+  ///The default row cache capacity sets the default number of bytes used to
+  ///cache the distance rows of the motif set checks.
+  const std::size_t defaultRowCache = 64 << 20;
+
+  ///\brief This is the default certification tolerance.
+  ///
+  ///The default certification tolerance sets the default relative slack of
+  ///the range of the certification, which absorbs the rounding errors of
+  ///statistics computed in a different order than during the generation.
+  const double defaultTolerance = 1e-9;
 }
 
 #endif
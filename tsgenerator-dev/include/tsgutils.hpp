@@ -16,6 +16,8 @@
 #include <tsgenerator.hpp>
 #include <tsgtypes.hpp>
 #include <basets.hpp>
+#include <tpm.hpp>
+#include <distancekernel.hpp>
 
 
 namespace tsg {
@@ -34,57 +36,8 @@ namespace tsg {
   void minMaxDist(const rseq &timeSeries_in, const rseq &sums_in, const rseq
       &sumSquares_in, const int window_in, double &min_out, double &max_out) {
 
-    int window = window_in;
-    double rWindow = 1.0 / window;
-
-    int length = (int)(timeSeries_in.size());
-
-    //precompute running mean and standard deviation
-    rseq mean;
-    for (int i = 0; i < length - window + 1; i++)
-      mean.push_back(sums_in[i] * rWindow);
-    rseq var;
-    for (int i = 0; i < length - window + 1; i++)
-      var.push_back(sumSquares_in[i] * rWindow - mean[i] * mean[i]);
-    rseq sigma;
-    for (int i = 0; i < length - window + 1; i++)
-      sigma.push_back(var[i] > 1.0 ? sqrt(var[i]) : 1.0);
-
-    double q = 0.0;
-    double distance;
-    min_out = std::numeric_limits<double>::infinity();
-    max_out = 0.0;
-
-    //for each diagonal of non overlapping subsequences
-    for (int k = window - 1; k < length - window + 1; k++) {
-
-      //the dot product
-      q = 0.0;
-
-      //iterate throw the diagonal
-      for (int i = 0; i < length - window + 1 - k; i++) {
-
-        if (i == 0)
-          //compute the initial dot product
-          for (int j = 0; j < window; j++)
-            q += timeSeries_in[i + j] * timeSeries_in[k + j];
-        else
-          //compute dot product iteratively
-          q += timeSeries_in[i + window - 1] * timeSeries_in[i + k + window
-            - 1] - timeSeries_in[i - 1] * timeSeries_in[i + k - 1];
-
-        //compute distance with dot product
-        distance = 2 * (window - (q - window * mean[i] * mean[i + k])
-            / (sigma[i] * sigma[i + k]));
-
-        //save the best so far distances
-        if (distance < min_out)
-          min_out = distance;
-
-        if (distance > max_out)
-          max_out = distance;
-      }
-    }
+    tpmMinMax(timeSeries_in, sums_in, sumSquares_in, window_in, min_out,
+        max_out);
   };
 
   ///\brief Computes the running sum and sum of squares
@@ -236,11 +189,9 @@ namespace tsg {
   ///computed. The return value is the distance of the two z-normalized
   ///subsequences.
   double zNormEuclDist(const rseq &sequence_in, const int pos0_in, const int
-      pos1_in, const int window_in, const tsg::rseq sums_in, const tsg::rseq
-      sumSquares_in, const double bestSoFar_in) {
+      pos1_in, const int window_in, const tsg::rseq &sums_in, const tsg::rseq
+      &sumSquares_in, const double bestSoFar_in) {
 
-    tsg::rseq sums = sums_in;
-    tsg::rseq sumSquares = sumSquares_in;
     int length = sequence_in.size();
     int window = window_in;
     if (sequence_in.empty()) {
@@ -265,30 +216,63 @@ namespace tsg {
 
     double rWindow = 1.0 / window;
 
-    double mean0 = sums[pos0_in] * rWindow;
-    double stdDev0 = sumSquares[pos0_in] * rWindow  - mean0 * mean0;
-    stdDev0 = stdDev0 < 1.0 ? 1.0 : sqrt(stdDev0);
+    double mean0 = sums_in[pos0_in] * rWindow;
+    double var0 = sumSquares_in[pos0_in] * rWindow - mean0 * mean0;
+    double rSigma0 = var0 > 1.0 ? 1.0 / sqrt(var0) : 1.0;
 
-    double mean1 = sums[pos1_in] * rWindow;
-    double stdDev1 = sumSquares[pos1_in] * rWindow  - mean1 * mean1;
-    stdDev1 = stdDev1 < 1.0 ? 1.0 : sqrt(stdDev1);
+    double mean1 = sums_in[pos1_in] * rWindow;
+    double var1 = sumSquares_in[pos1_in] * rWindow - mean1 * mean1;
+    double rSigma1 = var1 > 1.0 ? 1.0 / sqrt(var1) : 1.0;
 
     //calculate the similarity
-    double sumOfSquares = 0.0;
-    double bestSoFar = bestSoFar_in * bestSoFar_in;
-    double norm0;
-    double norm1;
-    double diff;
-
-    for (int i = 0; i < window && sumOfSquares < bestSoFar; i++) {
-
-      norm0 = (sequence_in[pos0_in + i] - mean0) / stdDev0;
-      norm1 = (sequence_in[pos1_in + i] - mean1) / stdDev1;
-      diff = norm0 - norm1;
-      sumOfSquares += diff * diff;
+    return zNormDistance(sequence_in.data() + pos0_in, sequence_in.data()
+        + pos1_in, window, mean0, rSigma0, mean1, rSigma1, bestSoFar_in);
+  };
+
+  ///\brief Computes the distance of two subsequences with precomputed
+  ///statistics.
+  ///
+  ///\param [in] &sequence_in Hands over the sequence.
+  ///\param [in] pos0_in Hands over the position of the first subsequence.
+  ///\param [in] pos1_in Hands over the position of the second subsequence.
+  ///\param [in] &stats_in Hands over the subsequence statistics.
+  ///\param [in] bestSoFar_in Hands over the best similarity so far.
+  ///
+  ///\return The distance of the two z-normalized subsequences.
+  ///
+  ///This function computes the same distance as the version with running
+  ///sums, but reads the mean and inverse standard deviation of the
+  ///subsequences from the statistics.
+  double zNormEuclDist(const rseq &sequence_in, const int pos0_in, const int
+      pos1_in, const SubsequenceStats &stats_in, const double bestSoFar_in) {
+
+    int length = sequence_in.size();
+    int window = stats_in.getWindow();
+    if (sequence_in.empty()) {
+
+      std::cerr << "ERROR: Time series is empty!" << std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    if (pos0_in + window > length || pos0_in < 0) {
+
+      std::cerr << "ERROR: Position of first subsequence " <<
+        pos0_in << " in similarity function is wrong!" << std::endl;
+      throw(EXIT_FAILURE);
     }
 
-    return sqrt(sumOfSquares);
+    if (pos1_in + window > length || pos1_in < 0) {
+
+      std::cerr << "ERROR: Position of second subsequence " <<
+        pos1_in << " in similarity function is wrong!" << std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    //calculate the similarity
+    return zNormDistance(sequence_in.data() + pos0_in, sequence_in.data()
+        + pos1_in, window, stats_in.getMean()[pos0_in],
+        stats_in.getRSigma()[pos0_in], stats_in.getMean()[pos1_in],
+        stats_in.getRSigma()[pos1_in], bestSoFar_in);
   };
 }
 
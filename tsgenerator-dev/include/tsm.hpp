@@ -15,6 +15,8 @@
 #include <random>
 #include <chrono>
 #include <tsgtypes.hpp>
+#include <subsequencestats.hpp>
+#include <distancekernel.hpp>
 
 
 namespace tsg {
@@ -42,6 +44,12 @@ namespace tsg {
       ///sequence.
       const rseq sumSquares;
 
+      ///\brief This variable stores the subsequence statistics.
+      ///
+      ///This variable stores the mean and inverse standard deviation of each
+      ///subsequence of the objective sequence.
+      const SubsequenceStats stats;
+
       ///\brief This variable stores the last PAA representation.
       ///
       ///This variable stores the last PAA representation for running PAA
@@ -61,7 +69,8 @@ namespace tsg {
       ///\param [in] &sumSquares_in Hands over the running sum of squares.
       ///
       ///The constructor initializes the top set motif object including the
-      ///time series, running sum and sum of squares.
+      ///time series, running sum and sum of squares. The subsequence
+      ///statistics are computed once for the window size of the running sums.
       TSM(const rseq &timeSeries_in, const rseq &sums_in, const rseq
           &sumSquares_in);
 
@@ -19,6 +19,11 @@ namespace tsg {
 
   BaseTS::~BaseTS() { }
 
+  void BaseTS::seed(const unsigned int seed_in) {
+
+    randomEngine.seed(seed_in);
+  }
+
   void BaseTS::cubicSpline(const iseq &x_in, const rseq &y_in, rseq &a_out,
       rseq &b_out, rseq &c_out, rseq &d_out) {
 
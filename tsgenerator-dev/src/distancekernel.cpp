@@ -0,0 +1,245 @@
+///\file distancekernel.cpp
+///
+///\brief File contains the z-normalized Euclidean distance kernel.
+///
+///This is the source file of the vectorized distance kernel shared by the
+///similarity functions of the generator, the top set motif object and the
+///utilities.
+
+#include <distancekernel.hpp>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) \
+    || defined(__i386__))
+#define DISTANCEKERNEL_SIMD
+#include <immintrin.h>
+#endif
+
+
+namespace tsg {
+
+  ///\brief Sums the lanes of the distance kernel.
+  ///
+  ///\param [in] *lanes_in Hands over the eight lanes.
+  ///
+  ///\return The sum of the lanes.
+  ///
+  ///All kernels reduce their lanes with this function, such that the partial
+  ///sums of the early abandoning checks are identical.
+  static inline double reduceLanes(const double *lanes_in) {
+
+    return ((lanes_in[0] + lanes_in[1]) + (lanes_in[2] + lanes_in[3]))
+      + ((lanes_in[4] + lanes_in[5]) + (lanes_in[6] + lanes_in[7]));
+  }
+
+  ///\brief Adds the values behind the last full lane chunk.
+  ///
+  ///\param [in] *x0_in Hands over the values of the first subsequence.
+  ///\param [in] *x1_in Hands over the values of the second subsequence.
+  ///\param [in] start_in Hands over the first value behind the chunks.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] mean0_in Hands over the mean of the first subsequence.
+  ///\param [in] rSigma0_in Hands over the inverse standard deviation of the
+  ///first subsequence.
+  ///\param [in] mean1_in Hands over the mean of the second subsequence.
+  ///\param [in] rSigma1_in Hands over the inverse standard deviation of the
+  ///second subsequence.
+  ///\param [in] sum_in Hands over the sum of the chunks.
+  ///
+  ///\return The distance of the two z-normalized subsequences.
+  static inline double finishTail(const double *x0_in, const double *x1_in,
+      const int start_in, const int window_in, const double mean0_in, const
+      double rSigma0_in, const double mean1_in, const double rSigma1_in,
+      double sum_in) {
+
+    double diff;
+
+    for (int i = start_in; i < window_in; i++) {
+
+      diff = (x0_in[i] - mean0_in) * rSigma0_in - (x1_in[i] - mean1_in)
+        * rSigma1_in;
+      sum_in += diff * diff;
+    }
+
+    return sqrt(sum_in);
+  }
+
+  ///\brief Computes the distance of two z-normalized subsequences.
+  ///
+  ///This is the scalar kernel, see zNormDistance. It sums the squared
+  ///differences in the eight lanes of the SIMD kernels. A positive
+  ///fixedWindow replaces the window size by a compile-time constant.
+  template <int fixedWindow>
+  static double zNormDistanceScalar(const double *x0_in, const double *x1_in,
+      const int window_in, const double mean0_in, const double rSigma0_in,
+      const double mean1_in, const double rSigma1_in, const double
+      bestSoFar_in) {
+
+    //the window size, a compile-time constant for the specialized windows
+    const int window = fixedWindow > 0 ? fixedWindow : window_in;
+    const int chunks = window / 8;
+    double lanes[8] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    double sum = 0.0;
+    double diff;
+
+    for (int c = 0; c < chunks; ) {
+
+      int end = std::min(c + distanceKernelBlock / 8, chunks);
+
+      for (; c < end; c++)
+        for (int l = 0; l < 8; l++) {
+
+          diff = (x0_in[8 * c + l] - mean0_in) * rSigma0_in
+            - (x1_in[8 * c + l] - mean1_in) * rSigma1_in;
+          lanes[l] += diff * diff;
+        }
+
+      //early abandoning after each block
+      sum = reduceLanes(lanes);
+
+      if (sum >= bestSoFar_in)
+        return sqrt(sum);
+    }
+
+    return finishTail(x0_in, x1_in, 8 * chunks, window, mean0_in,
+        rSigma0_in, mean1_in, rSigma1_in, sum);
+  }
+
+#ifdef DISTANCEKERNEL_SIMD
+  ///\brief Computes the distance of two z-normalized subsequences.
+  ///
+  ///This kernel holds the eight lanes in two AVX registers, see
+  ///zNormDistance.
+  template <int fixedWindow>
+  __attribute__((target("avx2")))
+  static double zNormDistanceAVX2(const double *x0_in, const double *x1_in,
+      const int window_in, const double mean0_in, const double rSigma0_in,
+      const double mean1_in, const double rSigma1_in, const double
+      bestSoFar_in) {
+
+    //the window size, a compile-time constant for the specialized windows
+    const int window = fixedWindow > 0 ? fixedWindow : window_in;
+    const int chunks = window / 8;
+    double lanes[8];
+    double sum = 0.0;
+
+    const __m256d mean0 = _mm256_set1_pd(mean0_in);
+    const __m256d rSigma0 = _mm256_set1_pd(rSigma0_in);
+    const __m256d mean1 = _mm256_set1_pd(mean1_in);
+    const __m256d rSigma1 = _mm256_set1_pd(rSigma1_in);
+
+    __m256d low = _mm256_setzero_pd();
+    __m256d high = _mm256_setzero_pd();
+    __m256d diff;
+
+    for (int c = 0; c < chunks; ) {
+
+      int end = std::min(c + distanceKernelBlock / 8, chunks);
+
+      for (; c < end; c++) {
+
+        diff = _mm256_sub_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(
+                  x0_in + 8 * c), mean0), rSigma0), _mm256_mul_pd(
+              _mm256_sub_pd(_mm256_loadu_pd(x1_in + 8 * c), mean1), rSigma1));
+        low = _mm256_add_pd(low, _mm256_mul_pd(diff, diff));
+
+        diff = _mm256_sub_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(
+                  x0_in + 8 * c + 4), mean0), rSigma0), _mm256_mul_pd(
+              _mm256_sub_pd(_mm256_loadu_pd(x1_in + 8 * c + 4), mean1),
+              rSigma1));
+        high = _mm256_add_pd(high, _mm256_mul_pd(diff, diff));
+      }
+
+      //early abandoning after each block
+      _mm256_storeu_pd(lanes, low);
+      _mm256_storeu_pd(lanes + 4, high);
+      sum = reduceLanes(lanes);
+
+      if (sum >= bestSoFar_in)
+        return sqrt(sum);
+    }
+
+    return finishTail(x0_in, x1_in, 8 * chunks, window, mean0_in,
+        rSigma0_in, mean1_in, rSigma1_in, sum);
+  }
+
+  ///\brief Computes the distance of two z-normalized subsequences.
+  ///
+  ///This kernel holds the eight lanes in one AVX-512 register, see
+  ///zNormDistance.
+  template <int fixedWindow>
+  __attribute__((target("avx512f")))
+  static double zNormDistanceAVX512(const double *x0_in, const double *x1_in,
+      const int window_in, const double mean0_in, const double rSigma0_in,
+      const double mean1_in, const double rSigma1_in, const double
+      bestSoFar_in) {
+
+    //the window size, a compile-time constant for the specialized windows
+    const int window = fixedWindow > 0 ? fixedWindow : window_in;
+    const int chunks = window / 8;
+    double lanes[8];
+    double sum = 0.0;
+
+    const __m512d mean0 = _mm512_set1_pd(mean0_in);
+    const __m512d rSigma0 = _mm512_set1_pd(rSigma0_in);
+    const __m512d mean1 = _mm512_set1_pd(mean1_in);
+    const __m512d rSigma1 = _mm512_set1_pd(rSigma1_in);
+
+    __m512d acc = _mm512_setzero_pd();
+    __m512d diff;
+
+    for (int c = 0; c < chunks; ) {
+
+      int end = std::min(c + distanceKernelBlock / 8, chunks);
+
+      for (; c < end; c++) {
+
+        diff = _mm512_sub_pd(_mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(
+                  x0_in + 8 * c), mean0), rSigma0), _mm512_mul_pd(
+              _mm512_sub_pd(_mm512_loadu_pd(x1_in + 8 * c), mean1), rSigma1));
+        acc = _mm512_add_pd(acc, _mm512_mul_pd(diff, diff));
+      }
+
+      //early abandoning after each block
+      _mm512_storeu_pd(lanes, acc);
+      sum = reduceLanes(lanes);
+
+      if (sum >= bestSoFar_in)
+        return sqrt(sum);
+    }
+
+    return finishTail(x0_in, x1_in, 8 * chunks, window, mean0_in,
+        rSigma0_in, mean1_in, rSigma1_in, sum);
+  }
+#endif
+
+  double zNormDistance(const double *x0_in, const double *x1_in, const int
+      window_in, const double mean0_in, const double rSigma0_in, const double
+      mean1_in, const double rSigma1_in, const double bestSoFar_in) {
+
+    double bestSoFar = bestSoFar_in * bestSoFar_in;
+
+#ifdef DISTANCEKERNEL_SIMD
+    static const bool avx512 = __builtin_cpu_supports("avx512f");
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    return dispatchWindow(window_in, [&](auto fixedWindow) {
+
+#ifdef DISTANCEKERNEL_SIMD
+        if (avx512)
+          return zNormDistanceAVX512<decltype(fixedWindow)::value>(x0_in,
+              x1_in, window_in, mean0_in, rSigma0_in, mean1_in, rSigma1_in,
+              bestSoFar);
+
+        if (avx2)
+          return zNormDistanceAVX2<decltype(fixedWindow)::value>(x0_in,
+              x1_in, window_in, mean0_in, rSigma0_in, mean1_in, rSigma1_in,
+              bestSoFar);
+#endif
+
+        return zNormDistanceScalar<decltype(fixedWindow)::value>(x0_in,
+            x1_in, window_in, mean0_in, rSigma0_in, mean1_in, rSigma1_in,
+            bestSoFar);
+      });
+  }
+}
@@ -0,0 +1,445 @@
+///\file distanceprofile.cpp
+///
+///\brief File contains the DistanceProfile class definition.
+///
+///This is the source file of the DistanceProfile class. The DistanceProfile
+///computes the z-normalized Euclidean distances of one query to all
+///subsequences of a time series with the fast Fourier transform.
+
+
+#include <distanceprofile.hpp>
+
+
+namespace tsg {
+
+  void fftTwiddles(const int size_in, cseq &twiddles_out) {
+
+    const double pi = 3.14159265358979323846;
+
+    twiddles_out.resize(std::max(1, size_in / 2));
+
+    for (int k = 0; k < (int)twiddles_out.size(); k++)
+      twiddles_out[k] = std::complex<double>(cos(2.0 * pi * k / size_in),
+          -sin(2.0 * pi * k / size_in));
+  }
+
+  void fft(cseq &data_inout, const cseq &twiddles_in, const bool inverse_in) {
+
+    int size = (int)data_inout.size();
+
+    if (size < 1 || (size & (size - 1)) != 0) {
+
+      std::cerr << "ERROR: Size of the transform " << size << " is not a "
+        << "power of two!" << std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    if ((int)twiddles_in.size() < size / 2) {
+
+      std::cerr << "ERROR: Not enough twiddle factors!" << std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    std::complex<double> *x = data_inout.data();
+    double sign = inverse_in ? -1.0 : 1.0;
+    double wRe;
+    double wIm;
+    double vRe;
+    double vIm;
+
+    //reorder the sequence by bit reversed indices
+    for (int i = 1, j = 0; i < size; i++) {
+
+      int bit = size >> 1;
+
+      for (; j & bit; bit >>= 1)
+        j ^= bit;
+
+      j ^= bit;
+
+      if (i < j)
+        std::swap(x[i], x[j]);
+    }
+
+    //butterflies, the complex products are expanded to avoid the slow
+    //library multiplication
+    for (int len = 2; len <= size; len <<= 1) {
+
+      int half = len >> 1;
+      int step = size / len;
+
+      for (int i = 0; i < size; i += len)
+        for (int k = 0; k < half; k++) {
+
+          wRe = twiddles_in[k * step].real();
+          wIm = sign * twiddles_in[k * step].imag();
+
+          std::complex<double> &a = x[i + k];
+          std::complex<double> &b = x[i + k + half];
+
+          vRe = b.real() * wRe - b.imag() * wIm;
+          vIm = b.real() * wIm + b.imag() * wRe;
+
+          b = std::complex<double>(a.real() - vRe, a.imag() - vIm);
+          a = std::complex<double>(a.real() + vRe, a.imag() + vIm);
+        }
+    }
+
+    if (inverse_in) {
+
+      double rSize = 1.0 / size;
+
+      for (int i = 0; i < size; i++)
+        x[i] *= rSize;
+    }
+  }
+
+  void fft(cseq &data_inout, const bool inverse_in) {
+
+    cseq twiddles;
+
+    fftTwiddles((int)data_inout.size(), twiddles);
+    fft(data_inout, twiddles, inverse_in);
+  }
+
+  bool preferDistanceProfile(const int length_in, const int window_in, const
+      double range_in) {
+
+    int size = 1;
+
+    while (size < length_in)
+      size <<= 1;
+
+    //expected number of values evaluated before abandoning, plus the call
+    double values = std::min((double)window_in, range_in * range_in / 2.0
+        + 1.0) + 4.0;
+
+    return (length_in - window_in + 1) * values > size * log2(size);
+  }
+
+  bool preferSweep(const int run_in, const int window_in, const double
+      range_in) {
+
+    //expected number of values evaluated before abandoning, plus the call
+    double values = std::min((double)window_in, range_in * range_in / 2.0
+        + 1.0) + 4.0;
+
+    return run_in * values > window_in + 2.0 * run_in;
+  }
+
+  DistanceProfile::DistanceProfile(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in) : window(stats_in.getWindow()) {
+
+    int length = (int)timeSeries_in.size();
+    int count = stats_in.size();
+
+    if (count < 1 || length != count + window - 1) {
+
+      std::cerr << "ERROR: Statistics do not match the time series!" <<
+        std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    while (size < length)
+      size <<= 1;
+
+    //center the time series
+    for (int i = 0; i < length; i++)
+      center += timeSeries_in[i];
+
+    center /= length;
+    centered.resize(length);
+
+    for (int i = 0; i < length; i++) {
+
+      centered[i] = timeSeries_in[i] - center;
+      norm += centered[i] * centered[i];
+      maxValue = std::max(maxValue, std::abs(centered[i]));
+    }
+
+    norm = sqrt(norm);
+
+    //statistics of the centered subsequences
+    mean.resize(count);
+    rSigma = stats_in.getRSigma();
+    sums.resize(count);
+    energy.resize(count);
+
+    double sumSquare = 0.0;
+
+    for (int i = 0; i < count; i++) {
+
+      mean[i] = stats_in.getMean()[i] - center;
+      maxMean = std::max(maxMean, std::abs(mean[i]));
+
+      //recompute the running sums every window to bound their drift
+      if (i % window == 0) {
+
+        sums[i] = 0.0;
+        sumSquare = 0.0;
+
+        for (int j = 0; j < window; j++) {
+
+          sums[i] += centered[i + j];
+          sumSquare += centered[i + j] * centered[i + j];
+        }
+      }
+      else {
+
+        sums[i] = sums[i - 1] + centered[i + window - 1] - centered[i - 1];
+        sumSquare += centered[i + window - 1] * centered[i + window - 1]
+          - centered[i - 1] * centered[i - 1];
+      }
+
+      //squared norm of the subsequence normalized with the given statistics
+      energy[i] = std::max(0.0, (sumSquare - 2.0 * mean[i] * sums[i] + window
+            * mean[i] * mean[i]) * rSigma[i] * rSigma[i]);
+    }
+
+  }
+
+  DistanceProfile::~DistanceProfile() { }
+
+  void DistanceProfile::transform() {
+
+    if (!spectrum.empty())
+      return;
+
+    //spectrum of the centered time series
+    fftTwiddles(size, twiddles);
+    spectrum.assign(size, 0.0);
+
+    for (int i = 0; i < (int)centered.size(); i++)
+      spectrum[i] = centered[i];
+
+    fft(spectrum, twiddles);
+  }
+
+  void DistanceProfile::correlate(const double *query0_in, const double
+      *query1_in) {
+
+    double re;
+    double im;
+
+    transform();
+
+    //reversed queries, i.e., the convolution yields the dot products
+    buffer.assign(size, 0.0);
+
+    for (int k = 0; k < window; k++)
+      buffer[k] = std::complex<double>(query0_in[window - 1 - k], query1_in
+          ? query1_in[window - 1 - k] : 0.0);
+
+    fft(buffer, twiddles);
+
+    for (int i = 0; i < size; i++) {
+
+      re = buffer[i].real() * spectrum[i].real() - buffer[i].imag()
+        * spectrum[i].imag();
+      im = buffer[i].real() * spectrum[i].imag() + buffer[i].imag()
+        * spectrum[i].real();
+      buffer[i] = std::complex<double>(re, im);
+    }
+
+    fft(buffer, twiddles, true);
+  }
+
+  void DistanceProfile::distances(const double *qt_in, const int stride_in,
+      const double qtError_in, const double *query_in, const double mean_in,
+      const double rSigma_in, const double energy_in, rseq &profile_out) {
+
+    const double eps = std::numeric_limits<double>::epsilon();
+    int count = (int)mean.size();
+    double queryNorm = 0.0;
+    double querySum = 0.0;
+    double d;
+
+    for (int k = 0; k < window; k++) {
+
+      queryNorm += query_in[k] * query_in[k];
+      querySum += query_in[k];
+    }
+
+    queryNorm = sqrt(queryNorm);
+
+    //rounding error of the dot products and of the distance formula, the
+    //inverse standard deviations are at most 1
+    error = std::max(error, 2.0 * rSigma_in * qtError_in + 16.0 * eps * (2.0
+          * window + 2.0 * rSigma_in * (norm * queryNorm + (std::abs(querySum)
+              + 2.0 * window * std::abs(mean_in)) * maxMean)));
+
+    profile_out.resize(count);
+
+    for (int j = 0; j < count; j++) {
+
+      //the means need not be the exact means of the centered subsequences
+      d = energy_in + energy[j] - 2.0 * rSigma_in * rSigma[j] * (qt_in[j
+          * stride_in] - mean[j] * querySum - mean_in * sums[j] + window
+          * mean_in * mean[j]);
+
+      profile_out[j] = sqrt(std::max(d, 0.0));
+    }
+  }
+
+  double DistanceProfile::transformError(const double *query_in) const {
+
+    double queryNorm = 0.0;
+
+    for (int k = 0; k < window; k++)
+      queryNorm += query_in[k] * query_in[k];
+
+    return 16.0 * std::numeric_limits<double>::epsilon() * log2(2.0 * size)
+      * norm * sqrt(queryNorm);
+  }
+
+  void DistanceProfile::compute(const int pos_in, rseq &profile_out) {
+
+    compute(pos_in, -1, profile_out, profile_out);
+  }
+
+  void DistanceProfile::compute(const int pos0_in, const int pos1_in, rseq
+      &profile0_out, rseq &profile1_out) {
+
+    int count = (int)mean.size();
+
+    if (pos0_in < 0 || pos0_in >= count || pos1_in >= count) {
+
+      std::cerr << "ERROR: Position of query subsequence is wrong!" <<
+        std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    error = 0.0;
+
+    correlate(&centered[pos0_in], pos1_in >= 0 ? &centered[pos1_in] :
+        nullptr);
+
+    //the dot products are interleaved real and imaginary parts
+    const double *qt = reinterpret_cast<const double *>(buffer.data()) + 2
+      * (window - 1);
+
+    distances(qt, 2, transformError(&centered[pos0_in]), &centered[pos0_in],
+        mean[pos0_in], rSigma[pos0_in], energy[pos0_in], profile0_out);
+
+    if (pos1_in >= 0)
+      distances(qt + 1, 2, transformError(&centered[pos1_in]),
+          &centered[pos1_in], mean[pos1_in], rSigma[pos1_in],
+          energy[pos1_in], profile1_out);
+  }
+
+  void DistanceProfile::compute(const rseq &query_in, rseq &profile_out) {
+
+    if ((int)query_in.size() != window) {
+
+      std::cerr << "ERROR: Query length " << query_in.size() << " does not "
+        << "match the window size!" << std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    //statistics of the centered query
+    rseq query(window);
+    double queryMean = 0.0;
+    double var = 0.0;
+
+    for (int k = 0; k < window; k++) {
+
+      query[k] = query_in[k] - center;
+      queryMean += query[k];
+    }
+
+    queryMean /= window;
+
+    for (int k = 0; k < window; k++)
+      var += (query[k] - queryMean) * (query[k] - queryMean);
+
+    var /= window;
+
+    double rSigmaQuery = var > 1.0 ? 1.0 / sqrt(var) : 1.0;
+    double energyQuery = window * var * rSigmaQuery * rSigmaQuery;
+
+    error = 0.0;
+
+    correlate(query.data(), nullptr);
+    distances(reinterpret_cast<const double *>(buffer.data()) + 2 * (window
+          - 1), 2, transformError(query.data()), query.data(), queryMean,
+        rSigmaQuery, energyQuery, profile_out);
+  }
+
+  void DistanceProfile::sweep(const int pos_in, rseq &profile_out) {
+
+    const double eps = std::numeric_limits<double>::epsilon();
+    const double *x = centered.data();
+    int count = (int)mean.size();
+    double dot;
+
+    if (pos_in < 0 || pos_in >= count) {
+
+      std::cerr << "ERROR: Position of query subsequence is wrong!" <<
+        std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    if (rowPos >= 0 && pos_in == rowPos + 1) {
+
+      double first = x[pos_in - 1];
+      double last = x[pos_in + window - 1];
+
+      //derive the dot products from the previous row, the second buffer
+      //keeps the loop free of dependencies
+      nextRow.resize(count);
+
+      for (int j = 1; j < count; j++)
+        nextRow[j] = row[j - 1] - first * x[j - 1] + last * x[j + window - 1];
+
+      dot = 0.0;
+
+      for (int k = 0; k < window; k++)
+        dot += x[pos_in + k] * x[k];
+
+      nextRow[0] = dot;
+      row.swap(nextRow);
+
+      //each update rounds three times at the magnitude of a dot product
+      rowError += 4.0 * eps * window * maxValue * maxValue;
+    }
+    else if ((double)window * count > 2.0 * size * log2(size)) {
+
+      //the transform is cheaper than the dot products from scratch
+      correlate(&x[pos_in], nullptr);
+      row.resize(count);
+
+      for (int j = 0; j < count; j++)
+        row[j] = buffer[j + window - 1].real();
+
+      rowError = transformError(&x[pos_in]);
+    }
+    else {
+
+      //compute the dot products from scratch
+      row.resize(count);
+
+      for (int j = 0; j < count; j++) {
+
+        dot = 0.0;
+
+        for (int k = 0; k < window; k++)
+          dot += x[pos_in + k] * x[j + k];
+
+        row[j] = dot;
+      }
+
+      rowError = eps * window * window * maxValue * maxValue;
+    }
+
+    rowPos = pos_in;
+    error = 0.0;
+
+    distances(row.data(), 1, rowError, &x[pos_in], mean[pos_in],
+        rSigma[pos_in], energy[pos_in], profile_out);
+  }
+
+  double DistanceProfile::getError() const {
+
+    return error;
+  }
+}
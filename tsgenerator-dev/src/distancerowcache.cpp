@@ -0,0 +1,136 @@
+///\file distancerowcache.cpp
+///
+///\brief File contains the DistanceRowCache class definition.
+///
+///This is the source file of the DistanceRowCache class. The DistanceRowCache
+///stores the similarities of subsequences to all subsequences of a time series
+///and keeps them valid across edits of the time series.
+
+
+#include <distancerowcache.hpp>
+
+
+namespace tsg {
+
+  DistanceRowCache::DistanceRowCache(const int window_in, const std::size_t
+      bytes_in) : window(window_in), capacity(bytes_in / sizeof(double)) { }
+
+  DistanceRowCache::~DistanceRowCache() { }
+
+  void DistanceRowCache::evict(const std::size_t values_in) {
+
+    while (!rows.empty() && size + values_in > capacity) {
+
+      auto oldest = rows.find(order.back());
+
+      size -= oldest->second.row->size();
+      rows.erase(oldest);
+      order.pop_back();
+    }
+  }
+
+  void DistanceRowCache::setCapacity(const std::size_t bytes_in) {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    capacity = bytes_in / sizeof(double);
+
+    evict(0);
+  }
+
+  std::shared_ptr<rseq> DistanceRowCache::find(const int pos_in, const double
+      range_in) {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto itr = rows.find(pos_in);
+
+    if (itr == rows.end() || itr->second.range != range_in) {
+
+      misses++;
+      return nullptr;
+    }
+
+    hits++;
+    order.splice(order.begin(), order, itr->second.used);
+
+    return itr->second.row;
+  }
+
+  void DistanceRowCache::insert(const int pos_in, const double range_in, const
+      std::shared_ptr<rseq> &row_in) {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto itr = rows.find(pos_in);
+
+    if (itr != rows.end()) {
+
+      size -= itr->second.row->size();
+      order.erase(itr->second.used);
+      rows.erase(itr);
+    }
+
+    //the row does not fit at all
+    if (row_in->size() > capacity)
+      return;
+
+    evict(row_in->size());
+
+    order.push_front(pos_in);
+    rows[pos_in] = { row_in, range_in, order.begin() };
+    size += row_in->size();
+  }
+
+  void DistanceRowCache::invalidate(const int pos_in) {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto itr = rows.begin(); itr != rows.end(); ) {
+
+      //the subsequence of the row overlaps the edit
+      if (abs(itr->first - pos_in) < window) {
+
+        size -= itr->second.row->size();
+        order.erase(itr->second.used);
+        itr = rows.erase(itr);
+        continue;
+      }
+
+      //the subsequences overlapping the edit are unknown
+      rseq &row = *itr->second.row;
+      int start = std::max(0, pos_in - window + 1);
+      int end = std::min((int)row.size(), pos_in + window);
+
+      for (int j = start; j < end; j++)
+        row[j] = -1.0;
+
+      itr++;
+    }
+  }
+
+  void DistanceRowCache::clear() {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    rows.clear();
+    order.clear();
+    size = 0;
+    hits = 0;
+    misses = 0;
+  }
+
+  long DistanceRowCache::getHits() const {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return hits;
+  }
+
+  long DistanceRowCache::getMisses() const {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return misses;
+  }
+}
@@ -18,14 +18,23 @@ namespace tsg {
           int)(std::chrono::system_clock::now().time_since_epoch().count()))
     {
 
-    //create first large interval
-    interval first;
-    first.start = 0;
-    first.end = length_in - window;
-    freePositions.push_back(first);
+    //the number of positions
+    int count = std::max(0, length_in - window + 1);
+
+    while (leaves < count)
+      leaves *= 2;
+
+    //create the tree with all positions free
+    freePositions.assign(2 * leaves, 0);
+
+    for (int i = 0; i < count; i++)
+      freePositions[leaves + i] = 1;
+
+    for (int i = leaves - 1; i > 0; i--)
+      freePositions[i] = freePositions[2 * i] + freePositions[2 * i + 1];
 
     //initialize the free positions count
-    freeCount = first.end + 1;
+    freeCount = freePositions[1];
   }
 
   FreePositions::~FreePositions() {}
@@ -38,75 +47,122 @@ namespace tsg {
     return distribution(randomEngine);
   }
 
+  void FreePositions::block(const int node_in, const int low_in, const int
+      high_in, const int start_in, const int end_in) {
+
+    //the node is outside the range or blocked already
+    if (end_in < low_in || high_in < start_in || freePositions[node_in] == 0)
+      return;
+
+    //journal the node for a rollback
+    if (pending) {
+
+      journalNodes.push_back(node_in);
+      journalCounts.push_back(freePositions[node_in]);
+    }
+
+    //the node is inside the range
+    if (start_in <= low_in && high_in <= end_in) {
+
+      freePositions[node_in] = 0;
+      return;
+    }
+
+    int middle = (low_in + high_in) / 2;
+
+    block(2 * node_in, low_in, middle, start_in, end_in);
+    block(2 * node_in + 1, middle + 1, high_in, start_in, end_in);
+
+    freePositions[node_in] = freePositions[2 * node_in]
+      + freePositions[2 * node_in + 1];
+  }
+
   int FreePositions::calculateRandomPosition() {
 
     if (freeCount < 1)
       throw(EXIT_FAILURE);
 
     //calculate the free random position
-    randomPosition = randomNumber();
+    int rank = randomNumber();
+
+    //descend to the leaf of the free position with the rank
+    int node = 1;
 
-    //index of the interval containing the position
-    int iP = 0;
+    while (node < leaves) {
 
-    //offset the position to the first interval
-    randomPosition += freePositions[iP].start;
+      node *= 2;
 
-    //decode the random number into a position
-    while (randomPosition > freePositions[iP].end) {
+      if (freePositions[node] <= rank) {
 
-      randomPosition += freePositions[iP + 1].start - freePositions[iP].end
-        - 1;
-      iP++;
+        rank -= freePositions[node];
+        node++;
+      }
     }
 
+    randomPosition = node - leaves;
+
     return randomPosition;
   }
 
   void FreePositions::removePosition() {
 
-    //index of the interval containing the position
-    int iP = 0;
+    //block all positions closer than twice the window size
+    block(1, 0, leaves - 1, randomPosition - 2 * window + 1, randomPosition
+        + 2 * window - 1);
 
-    //determine the index of the interval containing the position
-    while (randomPosition > freePositions[iP].end)
-      iP++;
+    //update free count
+    freeCount = freePositions[1];
+  }
 
-    //split the interval
-    interval first;
-    first.start = freePositions[iP].start;
-    first.end = randomPosition - 2 * window;
+  iseq FreePositions::calculateRandomPositions(const int count_in) {
 
-    interval second;
-    second.start = randomPosition + 2 * window;
-    second.end = freePositions[iP].end;
+    if (freeCount < 1)
+      throw(EXIT_FAILURE);
 
-    //remove the old interval & update free count
-    freePositions.erase(freePositions.begin() + iP);
-    freeCount--;
+    iseq positions;
 
-    //if there is no position in the second interval
-    if (second.end - second.start < 0) {
+    pending = true;
 
-      //remove all positions right from removed position
-      freeCount -= second.end - randomPosition;
-    }
-    else {
+    while ((int)positions.size() < count_in && freeCount > 0) {
 
-      //else insert new interval and update position count
-      freeCount -= 2 * window - 1;
-      freePositions.insert(freePositions.begin() + iP, second);
+      positions.push_back(calculateRandomPosition());
+      removePosition();
     }
 
-    //analogous for left
-    if (first.end - first.start < 0) {
+    return positions;
+  }
 
-      freeCount -= randomPosition - first.start;
-    }
-    else {
+  void FreePositions::commitPositions() {
 
-      freeCount -= 2 * window - 1;
-      freePositions.insert(freePositions.begin() + iP, first);
-    }
+    pending = false;
+    journalNodes.clear();
+    journalCounts.clear();
+  }
+
+  void FreePositions::rollbackPositions() {
+
+    //restore the nodes in reverse order
+    for (int i = (int)journalNodes.size() - 1; i >= 0; i--)
+      freePositions[journalNodes[i]] = journalCounts[i];
+
+    freeCount = freePositions[1];
+
+    commitPositions();
+  }
+
+  void FreePositions::removePosition(const int pos_in) {
+
+    randomPosition = pos_in;
+    removePosition();
+  }
+
+  void FreePositions::seed(const unsigned int seed_in) {
+
+    randomEngine.seed(seed_in);
+  }
+
+  int FreePositions::getFreeCount() const {
+
+    return freeCount;
   }
 }
@@ -0,0 +1,209 @@
+///\file matrixprofile.cpp
+///
+///\brief File contains the MatrixProfile class definition.
+///
+///This is the source file of the MatrixProfile class. The MatrixProfile stores
+///the nearest neighbor of each subsequence of a time series and refreshes only
+///the subsequences touched by an edit of the time series.
+
+
+#include <matrixprofile.hpp>
+
+
+namespace tsg {
+
+  MatrixProfile::MatrixProfile(const int window_in, const int exclusion_in)
+    : window(window_in), exclusion(exclusion_in) { }
+
+  MatrixProfile::~MatrixProfile() { }
+
+  void MatrixProfile::computeAll(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int threads_in) {
+
+    //the profile is stored with squared distances
+    squaredMatrixProfile(timeSeries_in, stats_in, exclusion, profile, index,
+        threads_in);
+  }
+
+  void MatrixProfile::computeRows(const rseq &timeSeries_in, const rseq
+      &mean_in, const rseq &rSigma_in, const iseq &rows_in) {
+
+    const double *x = timeSeries_in.data();
+    int count = (int)mean_in.size();
+    double distance;
+    int last = -2;
+
+    //the dot products of the current row
+    rseq qt(count, 0.0);
+
+    for (auto &r : rows_in) {
+
+      if (last >= 0 && r - last <= window) {
+
+        //derive the dot products from the previous row, rows in between cost
+        //O(n) each, which is cheaper than O(n * window) from scratch
+        for (int s = last + 1; s <= r; s++) {
+
+          for (int l = count - 1; l > 0; l--)
+            qt[l] = qt[l - 1] - x[s - 1] * x[l - 1] + x[s + window - 1]
+              * x[l + window - 1];
+
+          qt[0] = 0.0;
+
+          for (int j = 0; j < window; j++)
+            qt[0] += x[s + j] * x[j];
+        }
+      }
+      else {
+
+        //compute the dot products from scratch
+        for (int l = 0; l < count; l++) {
+
+          qt[l] = 0.0;
+
+          for (int j = 0; j < window; j++)
+            qt[l] += x[r + j] * x[l + j];
+        }
+      }
+
+      last = r;
+
+      for (int l = 0; l < count; l++) {
+
+        //skip trivial matches
+        if (abs(r - l) < exclusion)
+          continue;
+
+        //clamped like the squared distances of the whole profile
+        distance = std::max(0.0, 2.0 * (window - (qt[l] - window * mean_in[r]
+                * mean_in[l]) * rSigma_in[r] * rSigma_in[l]));
+
+        //ties are broken by the smaller position like in the whole profile
+        if (distance < profile[r] || (distance == profile[r] && l
+              < index[r])) {
+
+          profile[r] = distance;
+          index[r] = l;
+        }
+
+        if (distance < profile[l] || (distance == profile[l] && r
+              < index[l])) {
+
+          profile[l] = distance;
+          index[l] = r;
+        }
+      }
+    }
+  }
+
+  void MatrixProfile::invalidate() {
+
+    changedCount = -1;
+  }
+
+  void MatrixProfile::invalidate(const int pos_in) {
+
+    //the whole profile is recomputed anyway
+    if (changedCount < 0)
+      return;
+
+    int start = std::max(0, pos_in - window + 1);
+    int end = std::min((int)changed.size(), pos_in + window);
+
+    for (int i = start; i < end; i++)
+      if (!changed[i]) {
+
+        changed[i] = 1;
+        changedCount++;
+      }
+  }
+
+  void MatrixProfile::refresh(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int threads_in) {
+
+    int count = stats_in.size();
+
+    if (changedCount == 0 && (int)profile.size() == count)
+      return;
+
+    iseq rows;
+    long cost = 0;
+
+    if (changedCount > 0 && (int)profile.size() == count) {
+
+      //rows of changed subsequences and of subsequences whose nearest
+      //neighbor changed
+      for (int i = 0; i < count; i++)
+        if (changed[i] || (index[i] >= 0 && changed[index[i]])) {
+
+          //the dot products of a row cost the rows to derive them from the
+          //previous one or window rows from scratch, its distances one row
+          cost += 1 + (rows.empty() ? window : std::min(i - rows.back(),
+                window));
+          rows.push_back(i);
+        }
+    }
+
+    //the whole profile costs about count / 2 rows
+    if (rows.empty() || 2 * cost > count)
+      computeAll(timeSeries_in, stats_in, threads_in);
+    else {
+
+      for (auto &r : rows) {
+
+        profile[r] = std::numeric_limits<double>::infinity();
+        index[r] = -1;
+      }
+
+      computeRows(timeSeries_in, stats_in.getMean(), stats_in.getRSigma(),
+          rows);
+    }
+
+    changed.assign(count, 0);
+    changedCount = 0;
+  }
+
+  void MatrixProfile::refresh(const rseq &timeSeries_in, const rseq &sums_in,
+      const rseq &sumSquares_in, const int threads_in) {
+
+    refresh(timeSeries_in, SubsequenceStats(window, sums_in, sumSquares_in),
+        threads_in);
+  }
+
+  double MatrixProfile::topPair(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, int &pos0_out, int &pos1_out, const int
+      threads_in) {
+
+    refresh(timeSeries_in, stats_in, threads_in);
+
+    double bsf = std::numeric_limits<double>::infinity();
+
+    for (int i = 0; i < (int)profile.size(); i++)
+      if (profile[i] < bsf) {
+
+        bsf = profile[i];
+        pos0_out = std::min(i, index[i]);
+        pos1_out = std::max(i, index[i]);
+      }
+
+    return sqrt(std::max(bsf, 0.0));
+  }
+
+  double MatrixProfile::topPair(const rseq &timeSeries_in, const rseq
+      &sums_in, const rseq &sumSquares_in, int &pos0_out, int &pos1_out,
+      const int threads_in) {
+
+    return topPair(timeSeries_in, SubsequenceStats(window, sums_in,
+          sumSquares_in), pos0_out, pos1_out, threads_in);
+  }
+
+  double MatrixProfile::distance(const int pos_in) const {
+
+    return sqrt(std::max(profile[pos_in], 0.0));
+  }
+
+  int MatrixProfile::neighbor(const int pos_in) const {
+
+    return index[pos_in];
+  }
+}
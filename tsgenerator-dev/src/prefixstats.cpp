@@ -0,0 +1,122 @@
+///\file prefixstats.cpp
+///
+///\brief File contains the PrefixStats class definition.
+///
+///This is the source file of the PrefixStats class. The PrefixStats stores the
+///compensated prefix sums of a time series, which answer the mean and the
+///standard deviation of any subsequence in constant time.
+
+
+#include <prefixstats.hpp>
+
+
+namespace tsg {
+
+  PrefixStats::PrefixStats() { }
+
+  PrefixStats::PrefixStats(const rseq &timeSeries_in) {
+
+    compute(timeSeries_in);
+  }
+
+  PrefixStats::~PrefixStats() { }
+
+  void PrefixStats::compute(const rseq &timeSeries_in) {
+
+    int count = (int)timeSeries_in.size();
+
+    sumHigh.resize(count + 1);
+    sumLow.resize(count + 1);
+    squareHigh.resize(count + 1);
+    squareLow.resize(count + 1);
+
+    double sum = 0.0, sumError = 0.0;
+    double square = 0.0, squareError = 0.0;
+    double product, productError;
+    double high;
+
+    sumHigh[0] = sumLow[0] = squareHigh[0] = squareLow[0] = 0.0;
+
+    for (int i = 0; i < count; i++) {
+
+      twoSum(sum, sumError, timeSeries_in[i]);
+
+      product = twoProduct(timeSeries_in[i], timeSeries_in[i], productError);
+      twoSum(square, squareError, product);
+      squareError += productError;
+
+      //renormalize, i.e., the low parts stay below an ulp of the high parts
+      high = sum + sumError;
+      sumError -= high - sum;
+      sum = high;
+
+      high = square + squareError;
+      squareError -= high - square;
+      square = high;
+
+      sumHigh[i + 1] = sum;
+      sumLow[i + 1] = sumError;
+      squareHigh[i + 1] = square;
+      squareLow[i + 1] = squareError;
+    }
+  }
+
+  void PrefixStats::sums(const int pos_in, const int length_in, double
+      &sumHigh_out, double &sumLow_out, double &squareHigh_out, double
+      &squareLow_out) const {
+
+    int end = pos_in + length_in;
+
+    //the differences of the high parts are rounded, their errors are kept
+    sumHigh_out = sumHigh[end];
+    sumLow_out = sumLow[end] - sumLow[pos_in];
+    twoSum(sumHigh_out, sumLow_out, -sumHigh[pos_in]);
+
+    squareHigh_out = squareHigh[end];
+    squareLow_out = squareLow[end] - squareLow[pos_in];
+    twoSum(squareHigh_out, squareLow_out, -squareHigh[pos_in]);
+  }
+
+  double PrefixStats::getMean(const int pos_in, const int length_in) const {
+
+    double sumHigh, sumLow, squareHigh, squareLow;
+
+    sums(pos_in, length_in, sumHigh, sumLow, squareHigh, squareLow);
+
+    return (sumHigh + sumLow) / length_in;
+  }
+
+  double PrefixStats::getVariance(const int pos_in, const int length_in)
+    const {
+
+    double sumHigh, sumLow, squareHigh, squareLow;
+    double result = 0.0, resultError = 0.0;
+    double product, productError;
+
+    sums(pos_in, length_in, sumHigh, sumLow, squareHigh, squareLow);
+
+    //length times the sum of squares
+    product = twoProduct(squareHigh, length_in, productError);
+    twoSum(result, resultError, product);
+    resultError += productError + squareLow * length_in;
+
+    //minus the squared sum
+    product = twoProduct(sumHigh, sumHigh, productError);
+    twoSum(result, resultError, -product);
+    resultError -= productError + (2.0 * sumHigh + sumLow) * sumLow;
+
+    return std::max(0.0, (result + resultError) / ((double)length_in
+          * length_in));
+  }
+
+  double PrefixStats::getStdDev(const int pos_in, const int length_in)
+    const {
+
+    return sqrt(getVariance(pos_in, length_in));
+  }
+
+  int PrefixStats::size() const {
+
+    return std::max(0, (int)sumHigh.size() - 1);
+  }
+}
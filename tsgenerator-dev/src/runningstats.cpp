@@ -0,0 +1,135 @@
+///\file runningstats.cpp
+///
+///\brief File contains the RunningStats class definition.
+///
+///This is the source file of the RunningStats class. The RunningStats
+///maintains the running sum and sum of squares of all subsequences of a time
+///series with compensated updates anchored to exact recomputations.
+
+
+#include <runningstats.hpp>
+
+
+namespace tsg {
+
+  RunningStats::RunningStats(const int window_in) : window(window_in) { }
+
+  RunningStats::~RunningStats() { }
+
+  void RunningStats::computeRange(const rseq &timeSeries_in, const int
+      start_in, const int end_in) {
+
+    double sum = 0.0, sumError = 0.0;
+    double sumSquare = 0.0, sumSquareError = 0.0;
+    double value;
+
+    for (int i = start_in; i < end_in; i++) {
+
+      double c = shift[i / runningStatsBlock];
+
+      //recompute exactly at the start and at each block
+      if (i == start_in || i % runningStatsBlock == 0) {
+
+        sum = sumError = sumSquare = sumSquareError = 0.0;
+
+        for (int j = 0; j < window; j++) {
+
+          value = timeSeries_in[i + j] - c;
+          twoSum(sum, sumError, value);
+          twoSum(sumSquare, sumSquareError, value * value);
+        }
+      }
+      else {
+
+        //the shifted value leaving the window is rounded as it was added
+        value = timeSeries_in[i + window - 1] - c;
+        twoSum(sum, sumError, value);
+        twoSum(sumSquare, sumSquareError, value * value);
+
+        value = timeSeries_in[i - 1] - c;
+        twoSum(sum, sumError, -value);
+        twoSum(sumSquare, sumSquareError, -(value * value));
+      }
+
+      sums[i] = sum + sumError;
+      sumSquares[i] = sumSquare + sumSquareError;
+    }
+  }
+
+  void RunningStats::compute(const rseq &timeSeries_in) {
+
+    int count = std::max(0, (int)timeSeries_in.size() - window + 1);
+
+    sums.resize(count);
+    sumSquares.resize(count);
+    shift.resize((count + runningStatsBlock - 1) / runningStatsBlock);
+
+    for (int b = 0; b < (int)shift.size(); b++)
+      shift[b] = timeSeries_in[b * runningStatsBlock];
+
+    computeRange(timeSeries_in, 0, count);
+  }
+
+  void RunningStats::update(const rseq &timeSeries_in, const int pos_in) {
+
+    //the whole statistics are outdated
+    if ((int)sums.size() != std::max(0, (int)timeSeries_in.size() - window
+          + 1)) {
+
+      compute(timeSeries_in);
+      return;
+    }
+
+    computeRange(timeSeries_in, std::max(0, pos_in - window + 1),
+        std::min((int)sums.size(), pos_in + window));
+  }
+
+  void RunningStats::update(const RunningStats &runnings_in, const int
+      pos_in) {
+
+    int end = std::min((int)sums.size(), pos_in + window);
+
+    for (int i = std::max(0, pos_in - window + 1); i < end; i++) {
+
+      sums[i] = runnings_in.sums[i];
+      sumSquares[i] = runnings_in.sumSquares[i];
+    }
+  }
+
+  void RunningStats::getRunnings(const int start_in, const int end_in, rseq
+      &sums_inout, rseq &sumSquares_inout) const {
+
+    double c;
+
+    for (int i = start_in; i < end_in; i++) {
+
+      c = shift[i / runningStatsBlock];
+
+      sums_inout[i] = window * c + sums[i];
+      sumSquares_inout[i] = sumSquares[i] + 2.0 * c * sums[i] + window * c
+        * c;
+    }
+  }
+
+  double RunningStats::getMean(const int pos_in) const {
+
+    return shift[pos_in / runningStatsBlock] + sums[pos_in] / window;
+  }
+
+  double RunningStats::getVariance(const int pos_in) const {
+
+    double mean = sums[pos_in] / window;
+
+    return std::max(0.0, sumSquares[pos_in] / window - mean * mean);
+  }
+
+  int RunningStats::getWindow() const {
+
+    return window;
+  }
+
+  int RunningStats::size() const {
+
+    return (int)sums.size();
+  }
+}
@@ -0,0 +1,217 @@
+///\file subsequencestats.cpp
+///
+///\brief File contains the SubsequenceStats class definition.
+///
+///This is the source file of the SubsequenceStats class. The SubsequenceStats
+///stores the mean and inverse standard deviation of all subsequences of a
+///time series in contiguous arrays.
+
+
+#include <subsequencestats.hpp>
+
+
+namespace tsg {
+
+  SubsequenceStats::SubsequenceStats(const int window_in)
+    : window(window_in) { }
+
+  SubsequenceStats::SubsequenceStats(const int window_in, const rseq
+      &sums_in, const rseq &sumSquares_in) : window(window_in) {
+
+    compute(sums_in, sumSquares_in);
+  }
+
+  SubsequenceStats::~SubsequenceStats() { }
+
+  void SubsequenceStats::computeRange(const rseq &sums_in, const rseq
+      &sumSquares_in, const int start_in, const int end_in) {
+
+    double rWindow = 1.0 / window;
+    double var;
+
+    for (int i = start_in; i < end_in; i++) {
+
+      mean[i] = sums_in[i] * rWindow;
+      var = sumSquares_in[i] * rWindow - mean[i] * mean[i];
+      rSigma[i] = var > 1.0 ? 1.0 / sqrt(var) : 1.0;
+    }
+  }
+
+  void SubsequenceStats::computeRange(const RunningStats &runnings_in, const
+      int start_in, const int end_in) {
+
+    double var;
+
+    for (int i = start_in; i < end_in; i++) {
+
+      mean[i] = runnings_in.getMean(i);
+      var = runnings_in.getVariance(i);
+      rSigma[i] = var > 1.0 ? 1.0 / sqrt(var) : 1.0;
+    }
+  }
+
+  void SubsequenceStats::compute(const rseq &sums_in, const rseq
+      &sumSquares_in) {
+
+    int count = (int)sums_in.size();
+
+    mean.resize(count);
+    rSigma.resize(count);
+
+    computeRange(sums_in, sumSquares_in, 0, count);
+  }
+
+  void SubsequenceStats::update(const rseq &sums_in, const rseq
+      &sumSquares_in, const int pos_in) {
+
+    //the whole statistics are outdated
+    if (mean.size() != sums_in.size()) {
+
+      compute(sums_in, sumSquares_in);
+      return;
+    }
+
+    computeRange(sums_in, sumSquares_in, std::max(0, pos_in - window + 1),
+        std::min((int)mean.size(), pos_in + window));
+  }
+
+  void SubsequenceStats::compute(const RunningStats &runnings_in) {
+
+    int count = runnings_in.size();
+
+    mean.resize(count);
+    rSigma.resize(count);
+
+    computeRange(runnings_in, 0, count);
+  }
+
+  void SubsequenceStats::update(const RunningStats &runnings_in, const int
+      pos_in) {
+
+    //the whole statistics are outdated
+    if ((int)mean.size() != runnings_in.size()) {
+
+      compute(runnings_in);
+      return;
+    }
+
+    computeRange(runnings_in, std::max(0, pos_in - window + 1),
+        std::min((int)mean.size(), pos_in + window));
+  }
+
+  void SubsequenceStats::compute(const PrefixStats &prefix_in) {
+
+    int count = std::max(0, prefix_in.size() - window + 1);
+    double var;
+
+    mean.resize(count);
+    rSigma.resize(count);
+
+    for (int i = 0; i < count; i++) {
+
+      mean[i] = prefix_in.getMean(i, window);
+      var = prefix_in.getVariance(i, window);
+      rSigma[i] = var > 1.0 ? 1.0 / sqrt(var) : 1.0;
+    }
+  }
+
+  void SubsequenceStats::computeSegmentRange(const rseq &timeSeries_in, const
+      int start_in, const int end_in) {
+
+    double rSegment = 1.0 / segment;
+    double sum;
+
+    for (int t = start_in; t < end_in; t++) {
+
+      sum = 0.0;
+
+      for (int i = 0; i < segment; i++)
+        sum += timeSeries_in[t + i];
+
+      segmentMean[t] = sum * rSegment;
+    }
+  }
+
+  void SubsequenceStats::computeSegments(const rseq &timeSeries_in, const int
+      segment_in) {
+
+    segment = std::min(segment_in, window);
+
+    if (segment < 1) {
+
+      segmentMean.clear();
+      return;
+    }
+
+    segmentMean.resize(timeSeries_in.size() - segment + 1);
+
+    //the prefix sums serve long segments in constant time
+    if (segment >= prefixSegment) {
+
+      PrefixStats prefix(timeSeries_in);
+
+      for (int t = 0; t < (int)segmentMean.size(); t++)
+        segmentMean[t] = prefix.getMean(t, segment);
+    }
+    else
+      computeSegmentRange(timeSeries_in, 0, (int)segmentMean.size());
+  }
+
+  void SubsequenceStats::updateSegments(const rseq &timeSeries_in, const int
+      pos_in) {
+
+    if (segment < 1)
+      return;
+
+    computeSegmentRange(timeSeries_in, std::max(0, pos_in - segment + 1),
+        std::min((int)segmentMean.size(), pos_in + window));
+  }
+
+  double SubsequenceStats::lowerBound(const int pos0_in, const int pos1_in,
+      const double bestSoFar_in) const {
+
+    if (segment < 1)
+      return 0.0;
+
+    double mean0 = mean[pos0_in];
+    double rSigma0 = rSigma[pos0_in];
+    double mean1 = mean[pos1_in];
+    double rSigma1 = rSigma[pos1_in];
+
+    //the bound of the segments and the margin for the rounding errors
+    double margin = 1e-9 * window;
+    double bestSoFar = (bestSoFar_in * bestSoFar_in + margin) / segment;
+    double sumOfSquares = 0.0;
+    double diff;
+
+    for (int t = 0; t + segment <= window && sumOfSquares < bestSoFar;
+        t += segment) {
+
+      diff = (segmentMean[pos0_in + t] - mean0) * rSigma0
+        - (segmentMean[pos1_in + t] - mean1) * rSigma1;
+      sumOfSquares += diff * diff;
+    }
+
+    return sqrt(std::max(0.0, sumOfSquares * segment - margin));
+  }
+
+  int SubsequenceStats::getWindow() const {
+
+    return window;
+  }
+
+  int SubsequenceStats::size() const {
+
+    return (int)mean.size();
+  }
+
+  const rseq &SubsequenceStats::getMean() const {
+
+    return mean;
+  }
+
+  const rseq &SubsequenceStats::getRSigma() const {
+
+    return rSigma;
+  }
+}
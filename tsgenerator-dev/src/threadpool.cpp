@@ -0,0 +1,147 @@
+///\file threadpool.cpp
+///
+///\brief File contains the ThreadPool class definition.
+///
+///This is the source file of the ThreadPool class. The ThreadPool runs blocks
+///of work on persistent threads, i.e., the threads are spawned once and reused
+///by all parallel procedures.
+
+
+#include <threadpool.hpp>
+
+
+namespace tsg {
+
+  ///\brief This variable tells if the thread is running a block.
+  static thread_local bool inBlock = false;
+
+  ThreadPool::ThreadPool() : next(0) { }
+
+  ThreadPool::~ThreadPool() {
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+
+    wake.notify_all();
+
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  ThreadPool &ThreadPool::shared() {
+
+    static ThreadPool pool;
+
+    return pool;
+  }
+
+  int ThreadPool::workers(const int threads_in) {
+
+    if (threads_in < 1)
+      return std::max(1, (int)std::thread::hardware_concurrency());
+
+    return threads_in;
+  }
+
+  void ThreadPool::work(const std::function<void(const int)> &job_in, const
+      int blocks_in) {
+
+    inBlock = true;
+
+    for (int block = next++; block < blocks_in; block = next++) {
+
+      try {
+
+        job_in(block);
+      }
+      catch (...) {
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+
+    inBlock = false;
+  }
+
+  void ThreadPool::loop() {
+
+    long seen = 0;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+
+      wake.wait(lock, [&]() { return stop || jobs != seen; });
+
+      if (stop)
+        return;
+
+      seen = jobs;
+
+      //the job is done already
+      if (job == nullptr)
+        continue;
+
+      //the job is read together with its number, hence a late thread joins
+      //the current job or none
+      busy++;
+
+      const std::function<void(const int)> &job = *this->job;
+      int count = blocks;
+
+      lock.unlock();
+      work(job, count);
+      lock.lock();
+
+      if (--busy == 0)
+        done.notify_all();
+    }
+  }
+
+  void ThreadPool::run(const int blocks_in, const std::function<void(const
+        int)> &block_in) {
+
+    //a single block or a nested job runs serially
+    if (blocks_in <= 1 || inBlock) {
+
+      for (int block = 0; block < blocks_in; block++)
+        block_in(block);
+
+      return;
+    }
+
+    std::lock_guard<std::mutex> serial(running);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      //the calling thread computes blocks as well
+      while ((int)threads.size() < blocks_in - 1)
+        threads.emplace_back(&ThreadPool::loop, this);
+
+      job = &block_in;
+      blocks = blocks_in;
+      next = 0;
+      error = nullptr;
+      jobs++;
+    }
+
+    wake.notify_all();
+    work(block_in, blocks_in);
+
+    //the cursor is exhausted, wait for the blocks still running
+    std::unique_lock<std::mutex> lock(mutex);
+
+    done.wait(lock, [&]() { return busy == 0; });
+
+    job = nullptr;
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+}
@@ -6,65 +6,1909 @@
 ///iteratively the diagonals of the distance matrix of the time series.
 
 #include <tpm.hpp>
+#include <distancekernel.hpp>
+#include <threadpool.hpp>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) \
+    || defined(__i386__))
+#define TPM_SIMD
+#include <immintrin.h>
+#endif
 
 
 namespace tsg {
 
-  double tpm(const rseq &timeSeries_in, const rseq &sums_in, const rseq
-      &sumSquares_in, int &pos0_out, int &pos1_out, const int window_in) {
+  ///\brief The number of rows of a tile.
+  ///
+  ///The SIMD kernels traverse up to tpmTileGroups lane groups of consecutive
+  ///diagonals in tiles of tpmTileRows rows, carrying the dot products of the
+  ///lanes from tile to tile. The time series, mean and inverse standard
+  ///deviation values of a tile are hence loaded once from memory and reused
+  ///from the cache by all lane groups, instead of being streamed from memory
+  ///for each lane group once the arrays exceed the cache. Each lane still
+  ///performs the same operations in the same order, i.e., the result does not
+  ///change.
+  static const int tpmTileRows = 4096;
 
-    int window = window_in;
-    double rWindow = 1.0 / window;
+#ifdef TPM_SIMD
+  ///\brief The number of lane groups of a tile.
+  static const int tpmTileGroups = 16;
+#endif
 
-    int length = (int)(timeSeries_in.size());
+  ///\brief The number of diagonals of a tile of the reducers.
+  ///
+  ///The reducers without a SIMD kernel traverse tpmTileDiagonals consecutive
+  ///diagonals in tiles of tpmTileRows rows like the SIMD kernels, see
+  ///reduceTiles().
+  static const int tpmTileDiagonals = 64;
+
+  ///\brief Evaluates a block of diagonals of the distance matrix.
+  ///
+  ///\param [in] *x_in Hands over the time series values.
+  ///\param [in] *mean_in Hands over the running mean.
+  ///\param [in] *rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] count_in Hands over the number of subsequences.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [in,out] &max_out Hands over and returns the maximum squared
+  ///distance. Only updated if withMax is set.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///This is the scalar kernel. It evaluates the diagonals kStart_in to
+  ///kEnd_in - 1 in ascending order. Positions are only updated on a strict
+  ///improvement, i.e., the first pair with the smallest distance is kept. A
+  ///positive fixedWindow replaces the window size by a compile-time constant.
+  template <bool withMax, int fixedWindow>
+  static void diagonalsScalar(const double *x_in, const double *mean_in, const
+      double *rSigma_in, const int count_in, const int window_in, const int
+      kStart_in, const int kEnd_in, double &min_out, double &max_out, int
+      &pos0_out, int &pos1_out) {
 
-    //precompute running mean and standard deviation
-    rseq mean;
-    for (int i = 0; i < length - window + 1; i++)
-      mean.push_back(sums_in[i] * rWindow);
-    rseq var;
-    for (int i = 0; i < length - window + 1; i++)
-      var.push_back(sumSquares_in[i] * rWindow - mean[i] * mean[i]);
-    rseq sigma;
-    for (int i = 0; i < length - window + 1; i++)
-      sigma.push_back(var[i] > 1.0 ? sqrt(var[i]) : 1.0);
+    const double *x = x_in;
+    //the window size, a compile-time constant for the specialized windows
+    const int window = fixedWindow > 0 ? fixedWindow : window_in;
 
     double q = 0.0;
     double distance;
-    double bsf = std::numeric_limits<double>::infinity();
 
     //for each diagonal of non overlapping subsequences
-    for (int k = window - 1; k < length - window + 1; k++) {
+    for (int k = kStart_in; k < kEnd_in; k++) {
 
-      //the dot product
+      //compute the initial dot product
       q = 0.0;
 
+      for (int j = 0; j < window; j++)
+        q += x[j] * x[k + j];
+
       //iterate throw the diagonal
-      for (int i = 0; i < length - window + 1 - k; i++) {
+      for (int i = 0; i < count_in - k; i++) {
 
-        if (i == 0)
-          //compute the initial dot product
-          for (int j = 0; j < window; j++)
-            q += timeSeries_in[i + j] * timeSeries_in[k + j];
-        else
-          //compute dot product iteratively
-          q += timeSeries_in[i + window - 1] * timeSeries_in[i + k + window
-            - 1] - timeSeries_in[i - 1] * timeSeries_in[i + k - 1];
+        //compute dot product iteratively
+        if (i > 0)
+          q += x[i + window - 1] * x[i + k + window - 1] - x[i - 1] * x[i + k
+            - 1];
 
         //compute distance with dot product
-        distance = 2 * (window - (q - window * mean[i] * mean[i + k])
-            / (sigma[i] * sigma[i + k]));
+        distance = 2.0 * (window - (q - window * mean_in[i] * mean_in[i + k])
+            * rSigma_in[i] * rSigma_in[i + k]);
 
         //save the best so far positions and distance
-        if (distance < bsf) {
+        if (distance < min_out) {
+
+          min_out = distance;
+          pos0_out = i;
+          pos1_out = i + k;
+        }
+
+        if (withMax && distance > max_out)
+          max_out = distance;
+      }
+    }
+  }
+
+#ifdef TPM_SIMD
+  ///\brief Evaluates the tails of a SIMD block of diagonals.
+  ///
+  ///\param [in] *x_in Hands over the time series values.
+  ///\param [in] *mean_in Hands over the running mean.
+  ///\param [in] *rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] count_in Hands over the number of subsequences.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] k_in Hands over the first diagonal of the block.
+  ///\param [in] lanes_in Hands over the number of diagonals in the block.
+  ///\param [in] *q_in Hands over the dot products of each lane after the
+  ///common part of the diagonals.
+  ///\param [in] *min_in Hands over the minimum squared distance of each lane.
+  ///\param [in] *pos_in Hands over the position of the minimum of each lane.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [in,out] &max_out Hands over and returns the maximum squared
+  ///distance. Only updated if withMax is set.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///The diagonal k_in + j is lanes_in - 1 - j cells longer than the common
+  ///part evaluated in the SIMD lanes. This function finishes these cells with
+  ///the same operations as the scalar kernel and merges the lanes in diagonal
+  ///order, such that the result is identical to the scalar kernel.
+  template <bool withMax, int fixedWindow>
+  static void diagonalsTails(const double *x_in, const double *mean_in, const
+      double *rSigma_in, const int count_in, const int window_in, const int
+      k_in, const int lanes_in, double *q_in, const double *min_in, const
+      double *pos_in, double &min_out, double &max_out, int &pos0_out, int
+      &pos1_out) {
+
+    const double *x = x_in;
+    //the window size, a compile-time constant for the specialized windows
+    const int window = fixedWindow > 0 ? fixedWindow : window_in;
+    int common = count_in - k_in - lanes_in + 1;
+    double distance;
+
+    for (int j = 0; j < lanes_in; j++) {
+
+      int k = k_in + j;
+      double q = q_in[j];
+      double best = min_in[j];
+      int pos = (int)pos_in[j];
+
+      for (int i = common; i < count_in - k; i++) {
+
+        q += x[i + window - 1] * x[i + k + window - 1] - x[i - 1] * x[i + k
+          - 1];
+
+        distance = 2.0 * (window - (q - window * mean_in[i] * mean_in[i + k])
+            * rSigma_in[i] * rSigma_in[i + k]);
+
+        if (distance < best) {
+
+          best = distance;
+          pos = i;
+        }
+
+        if (withMax && distance > max_out)
+          max_out = distance;
+      }
+
+      if (best < min_out) {
+
+        min_out = best;
+        pos0_out = pos;
+        pos1_out = pos + k;
+      }
+    }
+  }
+
+  ///\brief Evaluates a block of diagonals of the distance matrix with AVX2.
+  ///
+  ///\param [in] *x_in Hands over the time series values.
+  ///\param [in] *mean_in Hands over the running mean.
+  ///\param [in] *rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] count_in Hands over the number of subsequences.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [in,out] &max_out Hands over and returns the maximum squared
+  ///distance. Only updated if withMax is set.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///This kernel advances four consecutive diagonals at once, one per SIMD
+  ///lane. The lane groups are traversed in tiles, see tpmTileRows. The
+  ///remaining diagonals are evaluated by the scalar kernel.
+  template <bool withMax, int fixedWindow>
+  __attribute__((target("avx2")))
+  static void diagonalsAVX2(const double *x_in, const double *mean_in, const
+      double *rSigma_in, const int count_in, const int window_in, const int
+      kStart_in, const int kEnd_in, double &min_out, double &max_out, int
+      &pos0_out, int &pos1_out) {
+
+    const double *x = x_in;
+    //the window size, a compile-time constant for the specialized windows
+    const int window = fixedWindow > 0 ? fixedWindow : window_in;
+    int k = kStart_in;
+    int groups;
+
+    //state of the lanes of all lane groups of a tile
+    rseq q(4 * tpmTileGroups);
+    rseq min(4 * tpmTileGroups);
+    rseq pos(4 * tpmTileGroups);
+    rseq max(4 * tpmTileGroups);
+
+    const __m256d w = _mm256_set1_pd((double)window);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    for (; k + 4 <= kEnd_in; k += 4 * groups) {
+
+      groups = std::min(tpmTileGroups, (kEnd_in - k) / 4);
+
+      //compute the initial dot products
+      for (int l = 0; l < 4 * groups; l++) {
+
+        q[l] = 0.0;
+        min[l] = std::numeric_limits<double>::infinity();
+        pos[l] = -1.0;
+        max[l] = max_out;
+
+        for (int j = 0; j < window; j++)
+          q[l] += x[j] * x[k + l + j];
+      }
+
+      //iterate throw the common parts of the diagonals tile by tile
+      for (int iStart = 0; iStart < count_in - k - 3; iStart +=
+          tpmTileRows) {
+
+        for (int g = 0; g < groups; g++) {
+
+          int kg = k + 4 * g;
+          int iEnd = std::min(iStart + tpmTileRows, count_in - kg - 3);
+
+          //the common parts of the following lane groups are even shorter
+          if (iStart >= iEnd)
+            break;
+
+          __m256d vQ = _mm256_loadu_pd(q.data() + 4 * g);
+          __m256d vMin = _mm256_loadu_pd(min.data() + 4 * g);
+          __m256d vMax = _mm256_loadu_pd(max.data() + 4 * g);
+          __m256d vPos = _mm256_loadu_pd(pos.data() + 4 * g);
+          __m256d vI = _mm256_set1_pd((double)iStart);
+          __m256d vDist;
+          __m256d vMask;
+
+          for (int i = iStart; i < iEnd; i++) {
+
+            //compute dot products iteratively
+            if (i > 0)
+              vQ = _mm256_add_pd(vQ, _mm256_sub_pd(
+                    _mm256_mul_pd(_mm256_set1_pd(x[i + window - 1]),
+                      _mm256_loadu_pd(x + i + kg + window - 1)),
+                    _mm256_mul_pd(_mm256_set1_pd(x[i - 1]),
+                      _mm256_loadu_pd(x + i + kg - 1))));
+
+            //compute distances with dot products
+            vDist = _mm256_mul_pd(_mm256_set1_pd(window * mean_in[i]),
+                _mm256_loadu_pd(mean_in + i + kg));
+            vDist = _mm256_mul_pd(_mm256_sub_pd(vQ, vDist),
+                _mm256_set1_pd(rSigma_in[i]));
+            vDist = _mm256_mul_pd(vDist, _mm256_loadu_pd(rSigma_in + i
+                  + kg));
+            vDist = _mm256_mul_pd(two, _mm256_sub_pd(w, vDist));
+
+            //save the best so far positions and distances per lane
+            vMask = _mm256_cmp_pd(vDist, vMin, _CMP_LT_OQ);
+            vMin = _mm256_blendv_pd(vMin, vDist, vMask);
+            vPos = _mm256_blendv_pd(vPos, vI, vMask);
+            vI = _mm256_add_pd(vI, one);
+
+            if (withMax)
+              vMax = _mm256_blendv_pd(vMax, vDist, _mm256_cmp_pd(vDist,
+                    vMax, _CMP_GT_OQ));
+          }
+
+          _mm256_storeu_pd(q.data() + 4 * g, vQ);
+          _mm256_storeu_pd(min.data() + 4 * g, vMin);
+          _mm256_storeu_pd(max.data() + 4 * g, vMax);
+          _mm256_storeu_pd(pos.data() + 4 * g, vPos);
+        }
+      }
+
+      //finish the diagonals lane group by lane group in diagonal order
+      for (int g = 0; g < groups; g++) {
+
+        if (withMax)
+          for (int l = 4 * g; l < 4 * (g + 1); l++)
+            max_out = std::max(max_out, max[l]);
+
+        diagonalsTails<withMax, fixedWindow>(x, mean_in, rSigma_in,
+            count_in, window, k + 4 * g, 4, q.data() + 4 * g, min.data()
+            + 4 * g, pos.data() + 4 * g, min_out, max_out, pos0_out,
+            pos1_out);
+      }
+    }
+
+    diagonalsScalar<withMax, fixedWindow>(x, mean_in, rSigma_in, count_in,
+        window, k, kEnd_in, min_out, max_out, pos0_out, pos1_out);
+  }
+
+  ///\brief Evaluates a block of diagonals of the distance matrix with
+  ///AVX-512.
+  ///
+  ///\param [in] *x_in Hands over the time series values.
+  ///\param [in] *mean_in Hands over the running mean.
+  ///\param [in] *rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] count_in Hands over the number of subsequences.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [in,out] &max_out Hands over and returns the maximum squared
+  ///distance. Only updated if withMax is set.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///This kernel advances eight consecutive diagonals at once, one per SIMD
+  ///lane. The lane groups are traversed in tiles, see tpmTileRows. The
+  ///remaining diagonals are evaluated by the scalar kernel.
+  template <bool withMax, int fixedWindow>
+  __attribute__((target("avx512f")))
+  static void diagonalsAVX512(const double *x_in, const double *mean_in, const
+      double *rSigma_in, const int count_in, const int window_in, const int
+      kStart_in, const int kEnd_in, double &min_out, double &max_out, int
+      &pos0_out, int &pos1_out) {
+
+    const double *x = x_in;
+    //the window size, a compile-time constant for the specialized windows
+    const int window = fixedWindow > 0 ? fixedWindow : window_in;
+    int k = kStart_in;
+    int groups;
+
+    //state of the lanes of all lane groups of a tile
+    rseq q(8 * tpmTileGroups);
+    rseq min(8 * tpmTileGroups);
+    rseq pos(8 * tpmTileGroups);
+    rseq max(8 * tpmTileGroups);
+
+    const __m512d w = _mm512_set1_pd((double)window);
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d one = _mm512_set1_pd(1.0);
+
+    for (; k + 8 <= kEnd_in; k += 8 * groups) {
+
+      groups = std::min(tpmTileGroups, (kEnd_in - k) / 8);
+
+      //compute the initial dot products
+      for (int l = 0; l < 8 * groups; l++) {
+
+        q[l] = 0.0;
+        min[l] = std::numeric_limits<double>::infinity();
+        pos[l] = -1.0;
+        max[l] = max_out;
+
+        for (int j = 0; j < window; j++)
+          q[l] += x[j] * x[k + l + j];
+      }
+
+      //iterate throw the common parts of the diagonals tile by tile
+      for (int iStart = 0; iStart < count_in - k - 7; iStart +=
+          tpmTileRows) {
+
+        for (int g = 0; g < groups; g++) {
+
+          int kg = k + 8 * g;
+          int iEnd = std::min(iStart + tpmTileRows, count_in - kg - 7);
+
+          //the common parts of the following lane groups are even shorter
+          if (iStart >= iEnd)
+            break;
+
+          __m512d vQ = _mm512_loadu_pd(q.data() + 8 * g);
+          __m512d vMin = _mm512_loadu_pd(min.data() + 8 * g);
+          __m512d vMax = _mm512_loadu_pd(max.data() + 8 * g);
+          __m512d vPos = _mm512_loadu_pd(pos.data() + 8 * g);
+          __m512d vI = _mm512_set1_pd((double)iStart);
+          __m512d vDist;
+          __mmask8 mask;
+
+          for (int i = iStart; i < iEnd; i++) {
+
+            //compute dot products iteratively
+            if (i > 0)
+              vQ = _mm512_add_pd(vQ, _mm512_sub_pd(
+                    _mm512_mul_pd(_mm512_set1_pd(x[i + window - 1]),
+                      _mm512_loadu_pd(x + i + kg + window - 1)),
+                    _mm512_mul_pd(_mm512_set1_pd(x[i - 1]),
+                      _mm512_loadu_pd(x + i + kg - 1))));
+
+            //compute distances with dot products
+            vDist = _mm512_mul_pd(_mm512_set1_pd(window * mean_in[i]),
+                _mm512_loadu_pd(mean_in + i + kg));
+            vDist = _mm512_mul_pd(_mm512_sub_pd(vQ, vDist),
+                _mm512_set1_pd(rSigma_in[i]));
+            vDist = _mm512_mul_pd(vDist, _mm512_loadu_pd(rSigma_in + i
+                  + kg));
+            vDist = _mm512_mul_pd(two, _mm512_sub_pd(w, vDist));
+
+            //save the best so far positions and distances per lane
+            mask = _mm512_cmp_pd_mask(vDist, vMin, _CMP_LT_OQ);
+            vMin = _mm512_mask_blend_pd(mask, vMin, vDist);
+            vPos = _mm512_mask_blend_pd(mask, vPos, vI);
+            vI = _mm512_add_pd(vI, one);
+
+            if (withMax)
+              vMax = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(vDist, vMax,
+                    _CMP_GT_OQ), vMax, vDist);
+          }
+
+          _mm512_storeu_pd(q.data() + 8 * g, vQ);
+          _mm512_storeu_pd(min.data() + 8 * g, vMin);
+          _mm512_storeu_pd(max.data() + 8 * g, vMax);
+          _mm512_storeu_pd(pos.data() + 8 * g, vPos);
+        }
+      }
+
+      //finish the diagonals lane group by lane group in diagonal order
+      for (int g = 0; g < groups; g++) {
+
+        if (withMax)
+          for (int l = 8 * g; l < 8 * (g + 1); l++)
+            max_out = std::max(max_out, max[l]);
+
+        diagonalsTails<withMax, fixedWindow>(x, mean_in, rSigma_in,
+            count_in, window, k + 8 * g, 8, q.data() + 8 * g, min.data()
+            + 8 * g, pos.data() + 8 * g, min_out, max_out, pos0_out,
+            pos1_out);
+      }
+    }
+
+    diagonalsScalar<withMax, fixedWindow>(x, mean_in, rSigma_in, count_in,
+        window, k, kEnd_in, min_out, max_out, pos0_out, pos1_out);
+  }
+#endif
+
+  ///\brief Evaluates a block of diagonals of the distance matrix.
+  ///
+  ///\param [in] &timeSeries_in Hands over the time series.
+  ///\param [in] &mean_in Hands over the running mean.
+  ///\param [in] &rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [in,out] &max_out Hands over and returns the maximum squared
+  ///distance. Only updated if withMax is set.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///This function chooses the widest SIMD kernel supported by the processor
+  ///at runtime and falls back to the scalar kernel otherwise. All kernels
+  ///return identical results. The window sizes of dispatchWindow use
+  ///kernels specialized for the window size.
+  template <bool withMax>
+  static void diagonals(const rseq &timeSeries_in, const rseq &mean_in, const
+      rseq &rSigma_in, const int window_in, const int kStart_in, const int
+      kEnd_in, double &min_out, double &max_out, int &pos0_out, int
+      &pos1_out) {
 
-          bsf = distance;
+    int count = (int)mean_in.size();
+
+    dispatchWindow(window_in, [&](auto fixedWindow) {
+
+#ifdef TPM_SIMD
+        if (__builtin_cpu_supports("avx512f")) {
+
+          diagonalsAVX512<withMax, decltype(fixedWindow)::value>(
+              timeSeries_in.data(), mean_in.data(), rSigma_in.data(), count,
+              window_in, kStart_in, kEnd_in, min_out, max_out, pos0_out,
+              pos1_out);
+          return;
+        }
+
+        if (__builtin_cpu_supports("avx2")) {
+
+          diagonalsAVX2<withMax, decltype(fixedWindow)::value>(
+              timeSeries_in.data(), mean_in.data(), rSigma_in.data(), count,
+              window_in, kStart_in, kEnd_in, min_out, max_out, pos0_out,
+              pos1_out);
+          return;
+        }
+#endif
+
+        diagonalsScalar<withMax, decltype(fixedWindow)::value>(
+            timeSeries_in.data(), mean_in.data(), rSigma_in.data(), count,
+            window_in, kStart_in, kEnd_in, min_out, max_out, pos0_out,
+            pos1_out);
+      });
+  }
+
+  ///\brief The period of the exact dot product recomputation.
+  ///
+  ///The single precision kernels recompute the dot product of a diagonal
+  ///from scratch in every row divisible by tpmFloatPeriod instead of updating
+  ///it iteratively. Hence, the rounding errors of at most tpmFloatPeriod
+  ///iterative updates accumulate, independently of the length of the time
+  ///series. Each such chunk of rows subtracts the means of its first
+  ///subsequences as anchors from the values, i.e., the dot product and its
+  ///rounding errors scale with the local deviation of the values instead of
+  ///their deviation from the mean of the time series.
+  static const int tpmFloatPeriod = 256;
+
+  ///\brief Evaluates a block of diagonals in single precision.
+  ///
+  ///\param [in] *x_in Hands over the centered time series values.
+  ///\param [in] *mean_in Hands over the centered running mean.
+  ///\param [in] *rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] count_in Hands over the number of subsequences.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///This is the scalar single precision kernel. It evaluates the diagonals
+  ///like the double precision kernel, but recomputes the dot product every
+  ///tpmFloatPeriod rows.
+  static void diagonalsFloatScalar(const float *x_in, const float *mean_in,
+      const float *rSigma_in, const int count_in, const int window_in, const
+      int kStart_in, const int kEnd_in, float &min_out, int &pos0_out, int
+      &pos1_out) {
+
+    const float *x = x_in;
+    int window = window_in;
+    float w = (float)window;
+
+    float q = 0.0f;
+    float a = 0.0f;
+    float b = 0.0f;
+    float distance;
+
+    for (int k = kStart_in; k < kEnd_in; k++) {
+
+      for (int i = 0; i < count_in - k; i++) {
+
+        //recompute the dot product of the anchored values periodically to
+        //bound the drift
+        if (i % tpmFloatPeriod == 0) {
+
+          q = 0.0f;
+          a = mean_in[i];
+          b = mean_in[i + k];
+
+          for (int j = 0; j < window; j++)
+            q += (x[i + j] - a) * (x[i + k + j] - b);
+        }
+        else
+          q += (x[i + window - 1] - a) * (x[i + k + window - 1] - b) - (x[i
+              - 1] - a) * (x[i + k - 1] - b);
+
+        distance = 2.0f * (w - (q - w * (mean_in[i] - a) * (mean_in[i + k]
+                - b)) * rSigma_in[i] * rSigma_in[i + k]);
+
+        if (distance < min_out) {
+
+          min_out = distance;
           pos0_out = i;
           pos1_out = i + k;
         }
       }
     }
+  }
+
+#ifdef TPM_SIMD
+  ///\brief Evaluates the tails of a single precision SIMD block.
+  ///
+  ///\param [in] *x_in Hands over the centered time series values.
+  ///\param [in] *mean_in Hands over the centered running mean.
+  ///\param [in] *rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] count_in Hands over the number of subsequences.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] k_in Hands over the first diagonal of the block.
+  ///\param [in] lanes_in Hands over the number of diagonals in the block.
+  ///\param [in] *q_in Hands over the dot products of each lane after the
+  ///common part of the diagonals.
+  ///\param [in] *min_in Hands over the minimum squared distance of each lane.
+  ///\param [in] *pos_in Hands over the position of the minimum of each lane.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///This function finishes the diagonals of a block with the same operations
+  ///as the scalar single precision kernel and merges the lanes in diagonal
+  ///order.
+  static void diagonalsFloatTails(const float *x_in, const float *mean_in,
+      const float *rSigma_in, const int count_in, const int window_in, const
+      int k_in, const int lanes_in, const float *q_in, const float *min_in,
+      const int *pos_in, float &min_out, int &pos0_out, int &pos1_out) {
+
+    const float *x = x_in;
+    int window = window_in;
+    float w = (float)window;
+    int common = count_in - k_in - lanes_in + 1;
+    float distance;
+
+    for (int j = 0; j < lanes_in; j++) {
+
+      int k = k_in + j;
+      float q = q_in[j];
+      float best = min_in[j];
+      int pos = pos_in[j];
+
+      //the anchors of the chunk of the first row
+      float a = mean_in[common - common % tpmFloatPeriod];
+      float b = mean_in[common - common % tpmFloatPeriod + k];
+
+      for (int i = common; i < count_in - k; i++) {
+
+        if (i % tpmFloatPeriod == 0) {
+
+          q = 0.0f;
+          a = mean_in[i];
+          b = mean_in[i + k];
+
+          for (int l = 0; l < window; l++)
+            q += (x[i + l] - a) * (x[i + k + l] - b);
+        }
+        else
+          q += (x[i + window - 1] - a) * (x[i + k + window - 1] - b) - (x[i
+              - 1] - a) * (x[i + k - 1] - b);
+
+        distance = 2.0f * (w - (q - w * (mean_in[i] - a) * (mean_in[i + k]
+                - b)) * rSigma_in[i] * rSigma_in[i + k]);
+
+        if (distance < best) {
+
+          best = distance;
+          pos = i;
+        }
+      }
+
+      if (best < min_out) {
+
+        min_out = best;
+        pos0_out = pos;
+        pos1_out = pos + k;
+      }
+    }
+  }
+
+  ///\brief Evaluates a block of diagonals in single precision with AVX2.
+  ///
+  ///\param [in] *x_in Hands over the centered time series values.
+  ///\param [in] *mean_in Hands over the centered running mean.
+  ///\param [in] *rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] count_in Hands over the number of subsequences.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///This kernel advances eight consecutive diagonals at once, one per SIMD
+  ///lane. The remaining diagonals are evaluated by the scalar kernel.
+  __attribute__((target("avx2")))
+  static void diagonalsFloatAVX2(const float *x_in, const float *mean_in,
+      const float *rSigma_in, const int count_in, const int window_in, const
+      int kStart_in, const int kEnd_in, float &min_out, int &pos0_out, int
+      &pos1_out) {
+
+    const float *x = x_in;
+    int window = window_in;
+    int k = kStart_in;
+
+    alignas(32) float q[8];
+    alignas(32) float min[8];
+    alignas(32) int pos[8];
+
+    const __m256 w = _mm256_set1_ps((float)window);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256i one = _mm256_set1_epi32(1);
+
+    for (; k + 8 <= kEnd_in; k += 8) {
+
+      __m256 vQ = _mm256_setzero_ps();
+      float a = 0.0f;
+      __m256 vB = _mm256_setzero_ps();
+      __m256 vMin = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+      __m256i vPos = _mm256_set1_epi32(-1);
+      __m256i vI = _mm256_setzero_si256();
+      __m256 vDist;
+      __m256 vMask;
+      int common = count_in - k - 7;
+
+      for (int i = 0; i < common; i++) {
+
+        //recompute the dot products of the anchored values periodically to
+        //bound the drift
+        if (i % tpmFloatPeriod == 0) {
+
+          vQ = _mm256_setzero_ps();
+          a = mean_in[i];
+          vB = _mm256_loadu_ps(mean_in + i + k);
+
+          for (int j = 0; j < window; j++)
+            vQ = _mm256_add_ps(vQ, _mm256_mul_ps(_mm256_set1_ps(x[i + j] - a),
+                  _mm256_sub_ps(_mm256_loadu_ps(x + i + k + j), vB)));
+        }
+        else
+          vQ = _mm256_add_ps(vQ, _mm256_sub_ps(
+                _mm256_mul_ps(_mm256_set1_ps(x[i + window - 1] - a),
+                  _mm256_sub_ps(_mm256_loadu_ps(x + i + k + window - 1), vB)),
+                _mm256_mul_ps(_mm256_set1_ps(x[i - 1] - a),
+                  _mm256_sub_ps(_mm256_loadu_ps(x + i + k - 1), vB))));
+
+        vDist = _mm256_mul_ps(_mm256_set1_ps((float)window * (mean_in[i] - a)),
+            _mm256_sub_ps(_mm256_loadu_ps(mean_in + i + k), vB));
+        vDist = _mm256_mul_ps(_mm256_sub_ps(vQ, vDist),
+            _mm256_set1_ps(rSigma_in[i]));
+        vDist = _mm256_mul_ps(vDist, _mm256_loadu_ps(rSigma_in + i + k));
+        vDist = _mm256_mul_ps(two, _mm256_sub_ps(w, vDist));
+
+        vMask = _mm256_cmp_ps(vDist, vMin, _CMP_LT_OQ);
+        vMin = _mm256_blendv_ps(vMin, vDist, vMask);
+        vPos = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(vPos),
+              _mm256_castsi256_ps(vI), vMask));
+        vI = _mm256_add_epi32(vI, one);
+      }
+
+      _mm256_store_ps(q, vQ);
+      _mm256_store_ps(min, vMin);
+      _mm256_store_si256((__m256i *)pos, vPos);
+
+      diagonalsFloatTails(x, mean_in, rSigma_in, count_in, window, k, 8, q,
+          min, pos, min_out, pos0_out, pos1_out);
+    }
+
+    diagonalsFloatScalar(x, mean_in, rSigma_in, count_in, window, k, kEnd_in,
+        min_out, pos0_out, pos1_out);
+  }
+
+  ///\brief Evaluates a block of diagonals in single precision with AVX-512.
+  ///
+  ///\param [in] *x_in Hands over the centered time series values.
+  ///\param [in] *mean_in Hands over the centered running mean.
+  ///\param [in] *rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] count_in Hands over the number of subsequences.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///This kernel advances sixteen consecutive diagonals at once, one per SIMD
+  ///lane. The remaining diagonals are evaluated by the scalar kernel.
+  __attribute__((target("avx512f")))
+  static void diagonalsFloatAVX512(const float *x_in, const float *mean_in,
+      const float *rSigma_in, const int count_in, const int window_in, const
+      int kStart_in, const int kEnd_in, float &min_out, int &pos0_out, int
+      &pos1_out) {
+
+    const float *x = x_in;
+    int window = window_in;
+    int k = kStart_in;
+
+    alignas(64) float q[16];
+    alignas(64) float min[16];
+    alignas(64) int pos[16];
+
+    const __m512 w = _mm512_set1_ps((float)window);
+    const __m512 two = _mm512_set1_ps(2.0f);
+    const __m512i one = _mm512_set1_epi32(1);
+
+    for (; k + 16 <= kEnd_in; k += 16) {
+
+      __m512 vQ = _mm512_setzero_ps();
+      float a = 0.0f;
+      __m512 vB = _mm512_setzero_ps();
+      __m512 vMin = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+      __m512i vPos = _mm512_set1_epi32(-1);
+      __m512i vI = _mm512_setzero_si512();
+      __m512 vDist;
+      __mmask16 mask;
+      int common = count_in - k - 15;
+
+      for (int i = 0; i < common; i++) {
+
+        //recompute the dot products of the anchored values periodically to
+        //bound the drift
+        if (i % tpmFloatPeriod == 0) {
+
+          vQ = _mm512_setzero_ps();
+          a = mean_in[i];
+          vB = _mm512_loadu_ps(mean_in + i + k);
+
+          for (int j = 0; j < window; j++)
+            vQ = _mm512_add_ps(vQ, _mm512_mul_ps(_mm512_set1_ps(x[i + j] - a),
+                  _mm512_sub_ps(_mm512_loadu_ps(x + i + k + j), vB)));
+        }
+        else
+          vQ = _mm512_add_ps(vQ, _mm512_sub_ps(
+                _mm512_mul_ps(_mm512_set1_ps(x[i + window - 1] - a),
+                  _mm512_sub_ps(_mm512_loadu_ps(x + i + k + window - 1), vB)),
+                _mm512_mul_ps(_mm512_set1_ps(x[i - 1] - a),
+                  _mm512_sub_ps(_mm512_loadu_ps(x + i + k - 1), vB))));
+
+        vDist = _mm512_mul_ps(_mm512_set1_ps((float)window * (mean_in[i] - a)),
+            _mm512_sub_ps(_mm512_loadu_ps(mean_in + i + k), vB));
+        vDist = _mm512_mul_ps(_mm512_sub_ps(vQ, vDist),
+            _mm512_set1_ps(rSigma_in[i]));
+        vDist = _mm512_mul_ps(vDist, _mm512_loadu_ps(rSigma_in + i + k));
+        vDist = _mm512_mul_ps(two, _mm512_sub_ps(w, vDist));
+
+        mask = _mm512_cmp_ps_mask(vDist, vMin, _CMP_LT_OQ);
+        vMin = _mm512_mask_blend_ps(mask, vMin, vDist);
+        vPos = _mm512_mask_blend_epi32(mask, vPos, vI);
+        vI = _mm512_add_epi32(vI, one);
+      }
+
+      _mm512_store_ps(q, vQ);
+      _mm512_store_ps(min, vMin);
+      _mm512_store_si512(pos, vPos);
+
+      diagonalsFloatTails(x, mean_in, rSigma_in, count_in, window, k, 16, q,
+          min, pos, min_out, pos0_out, pos1_out);
+    }
+
+    diagonalsFloatScalar(x, mean_in, rSigma_in, count_in, window, k, kEnd_in,
+        min_out, pos0_out, pos1_out);
+  }
+#endif
+
+  ///\brief Evaluates a block of diagonals in single precision.
+  ///
+  ///\param [in] *x_in Hands over the centered time series values.
+  ///\param [in] *mean_in Hands over the centered running mean.
+  ///\param [in] *rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] count_in Hands over the number of subsequences.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &min_out Hands over and returns the minimum squared
+  ///distance.
+  ///\param [out] &pos0_out Returns the position of the first subsequence.
+  ///\param [out] &pos1_out Returns the position of the second subsequence.
+  ///
+  ///This function chooses the widest single precision SIMD kernel supported
+  ///by the processor at runtime. All kernels return identical results.
+  static void diagonalsFloat(const float *x_in, const float *mean_in, const
+      float *rSigma_in, const int count_in, const int window_in, const int
+      kStart_in, const int kEnd_in, float &min_out, int &pos0_out, int
+      &pos1_out) {
+
+#ifdef TPM_SIMD
+    if (__builtin_cpu_supports("avx512f")) {
+
+      diagonalsFloatAVX512(x_in, mean_in, rSigma_in, count_in, window_in,
+          kStart_in, kEnd_in, min_out, pos0_out, pos1_out);
+      return;
+    }
+
+    if (__builtin_cpu_supports("avx2")) {
+
+      diagonalsFloatAVX2(x_in, mean_in, rSigma_in, count_in, window_in,
+          kStart_in, kEnd_in, min_out, pos0_out, pos1_out);
+      return;
+    }
+#endif
+
+    diagonalsFloatScalar(x_in, mean_in, rSigma_in, count_in, window_in,
+        kStart_in, kEnd_in, min_out, pos0_out, pos1_out);
+  }
+
+  ///\brief Inserts a pair into a list of top pairs.
+  ///
+  ///\param [in] pos0_in Hands over the position of the first subsequence.
+  ///\param [in] pos1_in Hands over the position of the second subsequence.
+  ///\param [in] distance_in Hands over the squared distance of the pair.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] k_in Hands over the maximum number of pairs.
+  ///\param [in,out] &pos0_out Hands over and returns the first positions.
+  ///\param [in,out] &pos1_out Hands over and returns the second positions.
+  ///\param [in,out] &d_out Hands over and returns the squared distances.
+  ///
+  ///\return The squared distance a new pair has to beat.
+  ///
+  ///The list is sorted in ascending order of the distance. The pair is
+  ///discarded if an overlapping pair has a smaller or equal distance,
+  ///otherwise it replaces all overlapping pairs. The list is truncated to k_in
+  ///pairs.
+  static double topPairInsert(const int pos0_in, const int pos1_in, const
+      double distance_in, const int window_in, const int k_in, iseq &pos0_out,
+      iseq &pos1_out, rseq &d_out) {
+
+    int size = (int)d_out.size();
+    int kept = 0;
+
+    for (int i = 0; i < size; i++) {
+
+      //check for overlapping pairs
+      if (abs(pos0_out[i] - pos0_in) < window_in && abs(pos1_out[i] - pos1_in)
+          < window_in) {
+
+        if (d_out[i] <= distance_in)
+          return size < k_in ? std::numeric_limits<double>::infinity()
+            : d_out[size - 1];
+
+        continue;
+      }
+
+      pos0_out[kept] = pos0_out[i];
+      pos1_out[kept] = pos1_out[i];
+      d_out[kept] = d_out[i];
+      kept++;
+    }
+
+    //insert the pair sorted by distance
+    int pos = kept;
+
+    while (pos > 0 && d_out[pos - 1] > distance_in)
+      pos--;
+
+    pos0_out.insert(pos0_out.begin() + pos, pos0_in);
+    pos1_out.insert(pos1_out.begin() + pos, pos1_in);
+    d_out.insert(d_out.begin() + pos, distance_in);
+
+    size = std::min(kept + 1, k_in);
+    pos0_out.resize(size);
+    pos1_out.resize(size);
+    d_out.resize(size);
+
+    return size < k_in ? std::numeric_limits<double>::infinity() : d_out[size
+      - 1];
+  }
+
+  ///\brief This reducer keeps the minimum and maximum distance.
+  ///
+  ///The reducer keeps the first pair with the smallest squared distance and,
+  ///if withMax is set, the largest squared distance. Its blocks are evaluated
+  ///by the SIMD kernels.
+  template <bool withMax>
+  struct MinReducer {
+
+    double min = std::numeric_limits<double>::infinity();
+    double max = 0.0;
+    int pos0 = -1;
+    int pos1 = -1;
+
+    void merge(const MinReducer &other_in) {
+
+      if (other_in.min < min) {
+
+        min = other_in.min;
+        pos0 = other_in.pos0;
+        pos1 = other_in.pos1;
+      }
+
+      if (withMax && other_in.max > max)
+        max = other_in.max;
+    }
+  };
+
+  ///\brief This reducer keeps the minimum distance in single precision.
+  ///
+  ///The reducer refers to the centered single precision time series, mean
+  ///and inverse standard deviation and keeps the first pair with the
+  ///smallest squared distance. Its blocks are evaluated by the single
+  ///precision SIMD kernels.
+  struct FloatMinReducer {
+
+    const float *x = nullptr;
+    const float *mean = nullptr;
+    const float *rSigma = nullptr;
+    int count = 0;
+    float min = std::numeric_limits<float>::infinity();
+    int pos0 = -1;
+    int pos1 = -1;
+
+    void merge(const FloatMinReducer &other_in) {
+
+      if (other_in.min < min) {
+
+        min = other_in.min;
+        pos0 = other_in.pos0;
+        pos1 = other_in.pos1;
+      }
+    }
+  };
+
+  ///\brief This reducer keeps up to k non overlapping pairs.
+  ///
+  ///The reducer keeps the pairs with topPairInsert(). Only distances smaller
+  ///than the distance of the worst kept pair touch the list. The kept pairs
+  ///depend on the order of the distances and on the blocks of the traversal,
+  ///but they never overlap each other, hence the distance of the worst kept
+  ///pair bounds the distances of the exact selection, see tpmTopK().
+  struct TopKReducer {
+
+    static const bool anyOrder = false;
+
+    int window = 0;
+    int k = 0;
+    double threshold = std::numeric_limits<double>::infinity();
+    iseq pos0;
+    iseq pos1;
+    rseq d;
+
+    void operator()(const int i_in, const int j_in, const double
+        distance_in) {
+
+      if (distance_in < threshold)
+        threshold = topPairInsert(i_in, j_in, distance_in, window, k, pos0,
+            pos1, d);
+    }
+
+    void merge(const TopKReducer &other_in) {
+
+      iseq pos0Old;
+      iseq pos1Old;
+      rseq dOld;
+
+      pos0Old.swap(pos0);
+      pos1Old.swap(pos1);
+      dOld.swap(d);
+
+      //insert the pairs of both lists in ascending order of the distance
+      int a = 0;
+      int b = 0;
+
+      while (a < (int)dOld.size() || b < (int)other_in.d.size()) {
+
+        if (b >= (int)other_in.d.size() || (a < (int)dOld.size() && dOld[a]
+              <= other_in.d[b])) {
+
+          topPairInsert(pos0Old[a], pos1Old[a], dOld[a], window, k, pos0,
+              pos1, d);
+          a++;
+        }
+        else {
+
+          topPairInsert(other_in.pos0[b], other_in.pos1[b], other_in.d[b],
+              window, k, pos0, pos1, d);
+          b++;
+        }
+      }
+
+      threshold = (int)d.size() < k ? std::numeric_limits<double>::infinity()
+        : d.back();
+    }
+  };
+
+  ///\brief This struct represents a candidate pair of tpmTopK().
+  struct TopKCandidate {
+
+    double d;
+    int pos0;
+    int pos1;
+  };
+
+  ///\brief This reducer collects the pairs within a threshold.
+  ///
+  ///The reducer keeps every pair whose squared distance does not exceed the
+  ///threshold. The pairs are sorted before they are selected, hence the
+  ///result does not depend on the order of the distances.
+  struct CollectReducer {
+
+    static const bool anyOrder = true;
+
+    double threshold = 0.0;
+    std::vector<TopKCandidate> pairs;
+
+    void operator()(const int i_in, const int j_in, const double
+        distance_in) {
+
+      if (distance_in <= threshold)
+        pairs.push_back({distance_in, i_in, j_in});
+    }
+
+    void merge(const CollectReducer &other_in) {
+
+      pairs.insert(pairs.end(), other_in.pairs.begin(),
+          other_in.pairs.end());
+    }
+  };
+
+  ///\brief This reducer keeps the row and column minima.
+  ///
+  ///The reducer keeps for each subsequence the smallest squared distance and
+  ///the position of the corresponding subsequence, i.e., the matrix profile.
+  ///Ties are broken by the smaller position, i.e., the result does not depend
+  ///on the order of the distances.
+  struct RowMinReducer {
+
+    static const bool anyOrder = true;
+
+    rseq profile;
+    iseq index;
+
+    void operator()(const int i_in, const int j_in, const double
+        distance_in) {
+
+      if (distance_in < profile[i_in] || (distance_in == profile[i_in]
+            && j_in < index[i_in])) {
+
+        profile[i_in] = distance_in;
+        index[i_in] = j_in;
+      }
+
+      if (distance_in < profile[j_in] || (distance_in == profile[j_in]
+            && i_in < index[j_in])) {
+
+        profile[j_in] = distance_in;
+        index[j_in] = i_in;
+      }
+    }
+
+    void merge(const RowMinReducer &other_in) {
+
+      for (int i = 0; i < (int)profile.size(); i++)
+        if (other_in.profile[i] < profile[i] || (other_in.profile[i]
+              == profile[i] && other_in.index[i] < index[i])) {
+
+          profile[i] = other_in.profile[i];
+          index[i] = other_in.index[i];
+        }
+    }
+  };
+
+  ///\brief This reducer counts the distances per histogram bin.
+  ///
+  ///The reducer counts the distances in bins of equal width between a minimum
+  ///and a maximum. Distances outside of the range are counted in the first or
+  ///last bin.
+  struct HistogramReducer {
+
+    static const bool anyOrder = true;
+
+    double min = 0.0;
+    double scale = 1.0;
+    lseq counts;
+
+    void operator()(const int, const int, const double distance_in) {
+
+      int bin = (int)((sqrt(std::max(distance_in, 0.0)) - min) * scale);
+
+      counts[std::min(std::max(bin, 0), (int)counts.size() - 1)]++;
+    }
+
+    void merge(const HistogramReducer &other_in) {
+
+      for (int i = 0; i < (int)counts.size(); i++)
+        counts[i] += other_in.counts[i];
+    }
+  };
+
+  ///\brief This reducer counts the distances below a threshold.
+  ///
+  ///The reducer compares the squared distances with the squared threshold,
+  ///i.e., no square root is computed.
+  struct CountReducer {
+
+    static const bool anyOrder = true;
+
+    double threshold = 0.0;
+    long long count = 0;
+
+    void operator()(const int, const int, const double distance_in) {
+
+      if (distance_in < threshold)
+        count++;
+    }
+
+    void merge(const CountReducer &other_in) {
+
+      count += other_in.count;
+    }
+  };
+
+  ///\brief Evaluates a block of diagonals with a reducer in tiles.
+  ///
+  ///\param [in] &timeSeries_in Hands over the time series.
+  ///\param [in] &mean_in Hands over the running mean.
+  ///\param [in] &rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &reducer_out Hands over and returns the reducer.
+  ///
+  ///This function traverses tpmTileDiagonals consecutive diagonals in tiles
+  ///of tpmTileRows rows and carries their dot products from tile to tile,
+  ///i.e., the values of a tile are reused from the cache like in the SIMD
+  ///kernels. Each diagonal performs the same operations in the same order as
+  ///in reduceBlock(), but the distances reach the reducer in tile order.
+  template <class Reducer>
+  static void reduceTiles(const rseq &timeSeries_in, const rseq &mean_in,
+      const rseq &rSigma_in, const int window_in, const int kStart_in, const
+      int kEnd_in, Reducer &reducer_out) {
+
+    const double *x = timeSeries_in.data();
+    const double *mean = mean_in.data();
+    const double *rSigma = rSigma_in.data();
+    int window = window_in;
+    int count = (int)mean_in.size();
+
+    double q[tpmTileDiagonals];
+    double distance;
+
+    for (int kGroup = kStart_in; kGroup < kEnd_in; kGroup +=
+        tpmTileDiagonals) {
+
+      int diagonals = std::min(tpmTileDiagonals, kEnd_in - kGroup);
+
+      //compute the initial dot products
+      for (int d = 0; d < diagonals; d++) {
+
+        q[d] = 0.0;
+
+        for (int j = 0; j < window; j++)
+          q[d] += x[j] * x[kGroup + d + j];
+      }
+
+      //iterate throw the diagonals tile by tile, the first one is the longest
+      for (int tile = 0; tile < count - kGroup; tile += tpmTileRows)
+        for (int d = 0; d < diagonals; d++) {
+
+          int k = kGroup + d;
+          int end = std::min(tile + tpmTileRows, count - k);
+
+          for (int i = tile; i < end; i++) {
+
+            //compute dot product iteratively
+            if (i > 0)
+              q[d] += x[i + window - 1] * x[i + k + window - 1] - x[i - 1]
+                * x[i + k - 1];
+
+            //compute distance with dot product
+            distance = 2.0 * (window - (q[d] - window * mean[i] * mean[i
+                  + k]) * rSigma[i] * rSigma[i + k]);
+
+            reducer_out(i, i + k, distance);
+          }
+        }
+    }
+  }
+
+  ///\brief Evaluates a block of diagonals with a reducer.
+  ///
+  ///\param [in] &timeSeries_in Hands over the time series.
+  ///\param [in] &mean_in Hands over the running mean.
+  ///\param [in] &rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal of the block.
+  ///\param [in] kEnd_in Hands over the diagonal behind the block.
+  ///\param [in,out] &reducer_out Hands over and returns the reducer.
+  ///
+  ///This function evaluates the diagonals kStart_in to kEnd_in - 1 in
+  ///ascending order and hands each squared distance with the positions of
+  ///its subsequences to the reducer. Reducers with a SIMD kernel specialize
+  ///this function, reducers whose result does not depend on the order of the
+  ///distances are traversed in tiles by reduceTiles().
+  template <class Reducer>
+  static void reduceBlock(const rseq &timeSeries_in, const rseq &mean_in,
+      const rseq &rSigma_in, const int window_in, const int kStart_in, const
+      int kEnd_in, Reducer &reducer_out) {
+
+    if (Reducer::anyOrder) {
+
+      reduceTiles(timeSeries_in, mean_in, rSigma_in, window_in, kStart_in,
+          kEnd_in, reducer_out);
+      return;
+    }
+
+    const double *x = timeSeries_in.data();
+    const double *mean = mean_in.data();
+    const double *rSigma = rSigma_in.data();
+    int window = window_in;
+    int count = (int)mean_in.size();
+
+    double q;
+    double distance;
+
+    for (int k = kStart_in; k < kEnd_in; k++) {
+
+      //compute the initial dot product
+      q = 0.0;
+
+      for (int j = 0; j < window; j++)
+        q += x[j] * x[k + j];
+
+      //iterate throw the diagonal
+      for (int i = 0; i < count - k; i++) {
+
+        //compute dot product iteratively
+        if (i > 0)
+          q += x[i + window - 1] * x[i + k + window - 1] - x[i - 1] * x[i + k
+            - 1];
+
+        //compute distance with dot product
+        distance = 2.0 * (window - (q - window * mean[i] * mean[i + k])
+            * rSigma[i] * rSigma[i + k]);
+
+        reducer_out(i, i + k, distance);
+      }
+    }
+  }
+
+  template <>
+  void reduceBlock<MinReducer<false>>(const rseq &timeSeries_in, const rseq
+      &mean_in, const rseq &rSigma_in, const int window_in, const int
+      kStart_in, const int kEnd_in, MinReducer<false> &reducer_out) {
+
+    diagonals<false>(timeSeries_in, mean_in, rSigma_in, window_in, kStart_in,
+        kEnd_in, reducer_out.min, reducer_out.max, reducer_out.pos0,
+        reducer_out.pos1);
+  }
+
+  template <>
+  void reduceBlock<MinReducer<true>>(const rseq &timeSeries_in, const rseq
+      &mean_in, const rseq &rSigma_in, const int window_in, const int
+      kStart_in, const int kEnd_in, MinReducer<true> &reducer_out) {
+
+    diagonals<true>(timeSeries_in, mean_in, rSigma_in, window_in, kStart_in,
+        kEnd_in, reducer_out.min, reducer_out.max, reducer_out.pos0,
+        reducer_out.pos1);
+  }
+
+  template <>
+  void reduceBlock<FloatMinReducer>(const rseq &, const rseq &, const rseq &,
+      const int window_in, const int kStart_in, const int kEnd_in,
+      FloatMinReducer &reducer_out) {
+
+    diagonalsFloat(reducer_out.x, reducer_out.mean, reducer_out.rSigma,
+        reducer_out.count, window_in, kStart_in, kEnd_in, reducer_out.min,
+        reducer_out.pos0, reducer_out.pos1);
+  }
+
+  ///\brief Evaluates diagonals of the distance matrix with a reducer.
+  ///
+  ///\param [in] &timeSeries_in Hands over the time series.
+  ///\param [in] &mean_in Hands over the running mean.
+  ///\param [in] &rSigma_in Hands over the running inverse standard deviation.
+  ///\param [in] window_in Hands over the window size.
+  ///\param [in] kStart_in Hands over the first diagonal.
+  ///\param [in] kEnd_in Hands over the diagonal behind the last one.
+  ///\param [in,out] &reducer_out Hands over and returns the reducer.
+  ///\param [in] threads_in Hands over the number of threads. A value smaller
+  ///than 1 uses all hardware threads.
+  ///
+  ///This is the diagonal traversal engine shared by all procedures. The
+  ///diagonal k has kEnd_in - k cells plus the initial dot product, hence the
+  ///diagonals are split into contiguous blocks of equal work, one per thread.
+  ///Each thread reduces its block into a copy of the reducer and the copies
+  ///are merged in diagonal order, such that ties are broken like in the
+  ///serial traversal.
+  template <class Reducer>
+  static void reduceDiagonals(const rseq &timeSeries_in, const rseq &mean_in,
+      const rseq &rSigma_in, const int window_in, const int kStart_in, const
+      int kEnd_in, Reducer &reducer_out, const int threads_in) {
+
+    int threads = ThreadPool::workers(threads_in);
+
+    if (threads == 1 || kEnd_in - kStart_in < 2 * threads) {
+
+      reduceBlock(timeSeries_in, mean_in, rSigma_in, window_in, kStart_in,
+          kEnd_in, reducer_out);
+      return;
+    }
+
+    //split the diagonals into blocks of equal work
+    double total = 0.0;
+
+    for (int k = kStart_in; k < kEnd_in; k++)
+      total += kEnd_in - k + window_in;
+
+    iseq bounds(1, kStart_in);
+    double work = 0.0;
+
+    for (int k = kStart_in; k < kEnd_in && (int)bounds.size() < threads;
+        k++) {
+
+      work += kEnd_in - k + window_in;
+
+      if (work >= total * bounds.size() / threads)
+        bounds.push_back(k + 1);
+    }
+
+    bounds.push_back(kEnd_in);
+    threads = (int)bounds.size() - 1;
+
+    //reducer of each block
+    std::vector<Reducer> reducers(threads, reducer_out);
+
+    ThreadPool::shared().run(threads, [&](const int t) {
+        reduceBlock(timeSeries_in, mean_in, rSigma_in, window_in, bounds[t],
+            bounds[t + 1], reducers[t]);
+        });
+
+    //merge in diagonal order
+    reducer_out = std::move(reducers[0]);
+
+    for (int t = 1; t < threads; t++)
+      reducer_out.merge(reducers[t]);
+  }
+
+  double tpm(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, int &pos0_out, int &pos1_out, const int window_in) {
+
+    return tpm(timeSeries_in, sums_in, sumSquares_in, pos0_out, pos1_out,
+        window_in, 1);
+  }
+
+  double tpm(const rseq &timeSeries_in, const SubsequenceStats &stats_in, int
+      &pos0_out, int &pos1_out, const int threads_in) {
+
+    int window = stats_in.getWindow();
+    int length = (int)(timeSeries_in.size());
+
+    const rseq &mean = stats_in.getMean();
+    const rseq &rSigma = stats_in.getRSigma();
+
+    MinReducer<false> reducer;
+
+    reduceDiagonals(timeSeries_in, mean, rSigma, window, window - 1, length
+        - window + 1, reducer, threads_in);
+
+    pos0_out = reducer.pos0;
+    pos1_out = reducer.pos1;
+
+    return sqrt(reducer.min);
+  }
+
+  double tpm(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, int &pos0_out, int &pos1_out, const int window_in,
+      const int threads_in) {
+
+    return tpm(timeSeries_in, SubsequenceStats(window_in, sums_in,
+          sumSquares_in), pos0_out, pos1_out, threads_in);
+  }
+
+  double tpmAnytime(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, int &pos0_out, int &pos1_out, const double seconds_in, const
+      int diagonals_in, std::mt19937 &randomEngine_in, double &fraction_out,
+      const int threads_in) {
+
+    //number of consecutive diagonals of a block, i.e., the SIMD lanes
+    const int blockSize = 8;
+
+    int window = stats_in.getWindow();
+    int length = (int)(timeSeries_in.size());
+    auto start = std::chrono::steady_clock::now();
+
+    //first diagonal and diagonal behind the last one
+    int kStart = window - 1;
+    int kEnd = length - window + 1;
+    int total = std::max(0, kEnd - kStart);
+
+    const rseq &mean = stats_in.getMean();
+    const rseq &rSigma = stats_in.getRSigma();
+
+    //shuffle the blocks of diagonals
+    iseq blocks;
+
+    for (int k = kStart; k < kEnd; k += blockSize)
+      blocks.push_back(k);
+
+    std::shuffle(blocks.begin(), blocks.end(), randomEngine_in);
+
+    //the diagonal budget cuts the shuffled blocks in advance, hence it does
+    //not depend on the timing or the number of threads
+    int count = (int)blocks.size();
+    int evaluated = 0;
+    iseq ends(count);
+
+    for (int b = 0; b < count; b++) {
+
+      ends[b] = std::min(blocks[b] + blockSize, kEnd);
+
+      if (diagonals_in > 0) {
+
+        if (evaluated >= diagonals_in) {
+
+          count = b;
+          break;
+        }
+
+        ends[b] = std::min(ends[b], blocks[b] + diagonals_in - evaluated);
+      }
+
+      evaluated += ends[b] - blocks[b];
+    }
+
+    //the threads take the blocks in shuffle order, each thread stops after a
+    //block once the time budget is exhausted, i.e., the evaluated blocks are
+    //a prefix of the shuffled blocks
+    std::vector<MinReducer<false>> reducers(count);
+    std::atomic<int> cursor(0);
+
+    ThreadPool::shared().run(std::min(ThreadPool::workers(threads_in),
+          std::max(1, count)), [&](const int) {
+        for (int b = cursor++; b < count; b = cursor++) {
+
+          reduceBlock(timeSeries_in, mean, rSigma, window, blocks[b], ends[b],
+              reducers[b]);
+
+          //stop if the time budget is exhausted
+          if (seconds_in > 0.0 && std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count()
+              >= seconds_in)
+            return;
+        }
+        });
+
+    //merge in shuffle order, such that ties are broken like in the serial
+    //traversal
+    MinReducer<false> reducer;
+
+    count = std::min(count, cursor.load());
+    evaluated = 0;
+
+    for (int b = 0; b < count; b++) {
+
+      reducer.merge(reducers[b]);
+      evaluated += ends[b] - blocks[b];
+    }
+
+    fraction_out = total > 0 ? (double)evaluated / total : 1.0;
+    pos0_out = reducer.pos0;
+    pos1_out = reducer.pos1;
+
+    return sqrt(reducer.min);
+  }
+
+  double tpmAnytime(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, int &pos0_out, int &pos1_out, const int window_in,
+      const double seconds_in, const int diagonals_in, std::mt19937
+      &randomEngine_in, double &fraction_out, const int threads_in) {
+
+    return tpmAnytime(timeSeries_in, SubsequenceStats(window_in, sums_in,
+          sumSquares_in), pos0_out, pos1_out, seconds_in, diagonals_in,
+        randomEngine_in, fraction_out, threads_in);
+  }
+
+  void tpmMinMax(const rseq &timeSeries_in, const SubsequenceStats &stats_in,
+      double &min_out, double &max_out, const int threads_in) {
+
+    int window = stats_in.getWindow();
+    int length = (int)(timeSeries_in.size());
+
+    const rseq &mean = stats_in.getMean();
+    const rseq &rSigma = stats_in.getRSigma();
+
+    MinReducer<true> reducer;
+
+    reduceDiagonals(timeSeries_in, mean, rSigma, window, window - 1, length
+        - window + 1, reducer, threads_in);
+
+    min_out = reducer.min;
+    max_out = reducer.max;
+  }
+
+  void tpmMinMax(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, const int window_in, double &min_out, double &max_out,
+      const int threads_in) {
+
+    tpmMinMax(timeSeries_in, SubsequenceStats(window_in, sums_in,
+          sumSquares_in), min_out, max_out, threads_in);
+  }
+
+  void tpmTopK(const rseq &timeSeries_in, const SubsequenceStats &stats_in,
+      const int k_in, iseq &pos0_out, iseq &pos1_out, rseq &d_out, const int
+      threads_in) {
+
+    int window = stats_in.getWindow();
+    int length = (int)(timeSeries_in.size());
+
+    pos0_out.clear();
+    pos1_out.clear();
+    d_out.clear();
+
+    if (k_in < 1)
+      return;
+
+    const rseq &mean = stats_in.getMean();
+    const rseq &rSigma = stats_in.getRSigma();
+
+    //one pair overlaps at most four non overlapping pairs, hence 4 k non
+    //overlapping pairs bound the distance of the k-th selected pair
+    TopKReducer bound;
+    bound.window = window;
+    bound.k = 4 * k_in;
+
+    reduceDiagonals(timeSeries_in, mean, rSigma, window, window - 1, length
+        - window + 1, bound, threads_in);
+
+    CollectReducer collect;
+    collect.threshold = (int)bound.d.size() < bound.k
+      ? std::numeric_limits<double>::infinity() : bound.d.back();
+
+    reduceDiagonals(timeSeries_in, mean, rSigma, window, window - 1, length
+        - window + 1, collect, threads_in);
+
+    //select the pairs in ascending order of the distance, ties in traversal
+    //order
+    std::vector<TopKCandidate> &pairs = collect.pairs;
+
+    std::sort(pairs.begin(), pairs.end(), [](const TopKCandidate &a_in, const
+          TopKCandidate &b_in) {
+        if (a_in.d != b_in.d)
+          return a_in.d < b_in.d;
+
+        if (a_in.pos1 - a_in.pos0 != b_in.pos1 - b_in.pos0)
+          return a_in.pos1 - a_in.pos0 < b_in.pos1 - b_in.pos0;
+
+        return a_in.pos0 < b_in.pos0;
+        });
+
+    for (auto &pair : pairs) {
+
+      if ((int)d_out.size() == k_in)
+        break;
+
+      bool overlap = false;
+
+      for (int i = 0; i < (int)d_out.size() && !overlap; i++)
+        if (abs(pos0_out[i] - pair.pos0) < window && abs(pos1_out[i]
+              - pair.pos1) < window)
+          overlap = true;
+
+      if (overlap)
+        continue;
+
+      pos0_out.push_back(pair.pos0);
+      pos1_out.push_back(pair.pos1);
+      d_out.push_back(sqrt(std::max(pair.d, 0.0)));
+    }
+  }
+
+  void tpmTopK(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, const int window_in, const int k_in, iseq &pos0_out,
+      iseq &pos1_out, rseq &d_out, const int threads_in) {
+
+    tpmTopK(timeSeries_in, SubsequenceStats(window_in, sums_in,
+          sumSquares_in), k_in, pos0_out, pos1_out, d_out, threads_in);
+  }
+
+  void tpmHistogram(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, const double min_in, const double max_in, const int bins_in,
+      lseq &counts_out, const int threads_in) {
+
+    if (bins_in < 1) {
+
+      std::cerr << "ERROR: Wrong number of histogram bins: " << bins_in <<
+        std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    if (!(max_in > min_in)) {
+
+      std::cerr << "ERROR: Wrong histogram range: " << min_in << " to " <<
+        max_in << std::endl;
+      throw(EXIT_FAILURE);
+    }
+
+    int window = stats_in.getWindow();
+    int length = (int)(timeSeries_in.size());
+
+    const rseq &mean = stats_in.getMean();
+    const rseq &rSigma = stats_in.getRSigma();
+
+    HistogramReducer reducer;
+    reducer.min = min_in;
+    reducer.scale = bins_in / (max_in - min_in);
+    reducer.counts.assign(bins_in, 0);
+
+    reduceDiagonals(timeSeries_in, mean, rSigma, window, window - 1, length
+        - window + 1, reducer, threads_in);
+
+    counts_out.swap(reducer.counts);
+  }
+
+  void tpmHistogram(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, const int window_in, const double min_in, const double
+      max_in, const int bins_in, lseq &counts_out, const int threads_in) {
+
+    tpmHistogram(timeSeries_in, SubsequenceStats(window_in, sums_in,
+          sumSquares_in), min_in, max_in, bins_in, counts_out, threads_in);
+  }
+
+  long long tpmCount(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, const double threshold_in, const int threads_in) {
+
+    int window = stats_in.getWindow();
+    int length = (int)(timeSeries_in.size());
+
+    if (threshold_in <= 0.0)
+      return 0;
+
+    const rseq &mean = stats_in.getMean();
+    const rseq &rSigma = stats_in.getRSigma();
+
+    CountReducer reducer;
+    reducer.threshold = threshold_in * threshold_in;
+
+    reduceDiagonals(timeSeries_in, mean, rSigma, window, window - 1, length
+        - window + 1, reducer, threads_in);
+
+    return reducer.count;
+  }
+
+  long long tpmCount(const rseq &timeSeries_in, const rseq &sums_in, const
+      rseq &sumSquares_in, const int window_in, const double threshold_in,
+      const int threads_in) {
+
+    return tpmCount(timeSeries_in, SubsequenceStats(window_in, sums_in,
+          sumSquares_in), threshold_in, threads_in);
+  }
+
+  double tpmFloat(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, int &pos0_out, int &pos1_out, const int threads_in) {
+
+    int window = stats_in.getWindow();
+    int length = (int)(timeSeries_in.size());
+    int count = stats_in.size();
+
+    const rseq &mean = stats_in.getMean();
+    const rseq &rSigma = stats_in.getRSigma();
+
+    //center the time series to bound the rounding of the values, the
+    //kernels subtract local anchors to avoid cancellation in the dot products
+    double center = 0.0;
+
+    for (auto &item : timeSeries_in)
+      center += item;
+
+    center /= std::max(length, 1);
+
+    fseq x(length);
+    fseq meanF(count);
+    fseq rSigmaF(count);
+
+    for (int i = 0; i < length; i++)
+      x[i] = (float)(timeSeries_in[i] - center);
+
+    for (int i = 0; i < count; i++) {
+
+      meanF[i] = (float)(mean[i] - center);
+      rSigmaF[i] = (float)rSigma[i];
+    }
+
+    FloatMinReducer reducer;
+    reducer.x = x.data();
+    reducer.mean = meanF.data();
+    reducer.rSigma = rSigmaF.data();
+    reducer.count = count;
+
+    reduceDiagonals(timeSeries_in, mean, rSigma, window, window - 1, length
+        - window + 1, reducer, threads_in);
+
+    pos0_out = reducer.pos0;
+    pos1_out = reducer.pos1;
+
+    if (pos0_out < 0)
+      return std::numeric_limits<double>::infinity();
+
+    //recompute the distance of the pair in double precision
+    double q = 0.0;
+
+    for (int j = 0; j < window; j++)
+      q += timeSeries_in[pos0_out + j] * timeSeries_in[pos1_out + j];
+
+    double distance = 2.0 * (window - (q - window * mean[pos0_out]
+          * mean[pos1_out]) * rSigma[pos0_out] * rSigma[pos1_out]);
+
+    return sqrt(std::max(distance, 0.0));
+  }
+
+  double tpmFloat(const rseq &timeSeries_in, const rseq &sums_in, const rseq
+      &sumSquares_in, int &pos0_out, int &pos1_out, const int window_in,
+      const int threads_in) {
+
+    return tpmFloat(timeSeries_in, SubsequenceStats(window_in, sums_in,
+          sumSquares_in), pos0_out, pos1_out, threads_in);
+  }
+
+  void runningsFloat(const fseq &timeSeries_in, const int window_in, fseq
+      &sums_out, fseq &sumSquares_out) {
+
+    int window = window_in;
+    int count = (int)timeSeries_in.size() - window + 1;
+    const float *x = timeSeries_in.data();
+
+    sums_out.assign(std::max(count, 0), 0.0f);
+    sumSquares_out.assign(std::max(count, 0), 0.0f);
+
+    float sum = 0.0f;
+    float sumSquare = 0.0f;
+
+    for (int i = 0; i < count; i++) {
+
+      //recompute the sums periodically to bound the drift
+      if (i % tpmFloatPeriod == 0) {
+
+        sum = 0.0f;
+        sumSquare = 0.0f;
+
+        for (int j = 0; j < window; j++) {
+
+          sum += x[i + j];
+          sumSquare += x[i + j] * x[i + j];
+        }
+      }
+      else {
+
+        sum += x[i + window - 1] - x[i - 1];
+        sumSquare += x[i + window - 1] * x[i + window - 1] - x[i - 1] * x[i
+          - 1];
+      }
+
+      sums_out[i] = sum;
+      sumSquares_out[i] = sumSquare;
+    }
+  }
+
+  float similarityFloat(const fseq &timeSeries_in, const fseq &sums_in, const
+      fseq &sumSquares_in, const int window_in, const int pos0_in, const int
+      pos1_in, const float bestSoFar_in) {
+
+    float rWindow = 1.0f / window_in;
+
+    float mean0 = sums_in[pos0_in] * rWindow;
+    float stdDev0 = sumSquares_in[pos0_in] * rWindow - mean0 * mean0;
+    stdDev0 = stdDev0 < 1.0f ? 1.0f : sqrtf(stdDev0);
+
+    float mean1 = sums_in[pos1_in] * rWindow;
+    float stdDev1 = sumSquares_in[pos1_in] * rWindow - mean1 * mean1;
+    stdDev1 = stdDev1 < 1.0f ? 1.0f : sqrtf(stdDev1);
+
+    //calculate the similarity
+    float sumOfSquares = 0.0f;
+    float bestSoFar = bestSoFar_in * bestSoFar_in;
+    float rStdDev0 = 1.0f / stdDev0;
+    float rStdDev1 = 1.0f / stdDev1;
+    float diff;
+
+    for (int i = 0; i < window_in && sumOfSquares < bestSoFar; i++) {
+
+      diff = (timeSeries_in[pos0_in + i] - mean0) * rStdDev0
+        - (timeSeries_in[pos1_in + i] - mean1) * rStdDev1;
+      sumOfSquares += diff * diff;
+    }
+
+    return sqrtf(sumOfSquares);
+  }
+
+  void squaredMatrixProfile(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, const int exclusion_in, rseq &profile_out, iseq &index_out,
+      const int threads_in) {
+
+    int window = stats_in.getWindow();
+    int count = stats_in.size();
+
+    const rseq &mean = stats_in.getMean();
+    const rseq &rSigma = stats_in.getRSigma();
+
+    RowMinReducer reducer;
+    reducer.profile.assign(count, std::numeric_limits<double>::infinity());
+    reducer.index.assign(count, -1);
+
+    reduceDiagonals(timeSeries_in, mean, rSigma, window, std::max(exclusion_in,
+          1), count, reducer, threads_in);
+
+    profile_out.swap(reducer.profile);
+    index_out.swap(reducer.index);
+
+    for (auto &item : profile_out)
+      item = std::max(item, 0.0);
+  }
+
+  void matrixProfile(const rseq &timeSeries_in, const SubsequenceStats
+      &stats_in, const int exclusion_in, rseq &profile_out, iseq &index_out,
+      const int threads_in) {
+
+    squaredMatrixProfile(timeSeries_in, stats_in, exclusion_in, profile_out,
+        index_out, threads_in);
+
+    for (auto &item : profile_out)
+      item = sqrt(item);
+  }
+
+  void matrixProfile(const rseq &timeSeries_in, const rseq &sums_in, const
+      rseq &sumSquares_in, const int window_in, const int exclusion_in, rseq
+      &profile_out, iseq &index_out, const int threads_in) {
 
-    return sqrt(bsf);
+    matrixProfile(timeSeries_in, SubsequenceStats(window_in, sums_in,
+          sumSquares_in), exclusion_in, profile_out, index_out, threads_in);
   }
 }
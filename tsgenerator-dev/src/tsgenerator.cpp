@@ -22,10 +22,12 @@ namespace tsg {
     noise(noise_in), type(abs(type_in)), size(abs(size_in)), height(height_in),
     step(abs(step_in)), times(abs(times_in)), method(abs(method_in)),
     maxi(abs(maxi_in)), gen(abs(gen_in)), smaller(abs(smaller_in)),
-    freePositions(length, window), randomEngine(std::random_device().entropy()
+    freePositions(length, window), matrixProfile(window, window - 1),
+    randomEngine(std::random_device().entropy()
       ? std::random_device()()
       : (unsigned
-        int)(std::chrono::system_clock::now().time_since_epoch().count())) {
+        int)(std::chrono::system_clock::now().time_since_epoch().count())),
+    runnings(window), stats(window), rowCache(window, defaultRowCache) {
 
     //check if type exists
     if (type >= (int) motifTypes.size()) {
@@ -72,10 +74,12 @@ namespace tsg {
     : length(abs(length_in)), window(window_in), delta(delta_in),
     noise(noise_in), size(abs(size_in)), height(height_in), step(abs(step_in)),
     times(abs(times_in)), maxi(abs(maxi_in)), smaller(abs(smaller_in)),
-    freePositions(length, window), randomEngine(std::random_device().entropy()
+    freePositions(length, window), matrixProfile(window, window - 1),
+    randomEngine(std::random_device().entropy()
       ? std::random_device()()
       : (unsigned
-        int)(std::chrono::system_clock::now().time_since_epoch().count())) {
+        int)(std::chrono::system_clock::now().time_since_epoch().count())),
+    runnings(window), stats(window), rowCache(window, defaultRowCache) {
 
     // get the type number
     type = (int)(std::distance(motifTypes.begin(),
@@ -135,10 +139,12 @@ namespace tsg {
     noise(noise_in), size(abs(size_in)), height(height_in),
     step(abs(step_in)), times(abs(times_in)), method(abs(method_in)),
     maxi(abs(maxi_in)), gen(abs(gen_in)), smaller(abs(smaller_in)),
-    freePositions(length, window), randomEngine(std::random_device().entropy()
+    freePositions(length, window), matrixProfile(window, window - 1),
+    randomEngine(std::random_device().entropy()
       ? std::random_device()()
       : (unsigned
-        int)(std::chrono::system_clock::now().time_since_epoch().count())) {
+        int)(std::chrono::system_clock::now().time_since_epoch().count())),
+    runnings(window), stats(window), rowCache(window, defaultRowCache) {
 
     // check if shape exists
     if (shape_in.empty()) {
@@ -189,10 +195,12 @@ namespace tsg {
     : length(abs(length_in)), window(window_in), delta(delta_in),
     noise(noise_in), size(abs(size_in)), height(height_in), step(abs(step_in)),
     times(abs(times_in)), maxi(abs(maxi_in)), smaller(abs(smaller_in)),
-    freePositions(length, window), randomEngine(std::random_device().entropy()
+    freePositions(length, window), matrixProfile(window, window - 1),
+    randomEngine(std::random_device().entropy()
       ? std::random_device()()
       : (unsigned
-        int)(std::chrono::system_clock::now().time_since_epoch().count())) {
+        int)(std::chrono::system_clock::now().time_since_epoch().count())),
+    runnings(window), stats(window), rowCache(window, defaultRowCache) {
 
     // check if shape exists
     if (shape_in.empty()) {
@@ -245,68 +253,178 @@ namespace tsg {
 
   TSGenerator::~TSGenerator() { }
 
+  void TSGenerator::setThreads(const int threads_in) {
+
+    threads = threads_in;
+  }
+
+  void TSGenerator::setSpeculation(const int speculation_in) {
+
+    speculation = speculation_in < 1 ? 1 : speculation_in;
+  }
+
+  void TSGenerator::setRowCache(const std::size_t bytes_in) {
+
+    rowCache.setCapacity(bytes_in);
+  }
+
+  long TSGenerator::getRowCacheHits() const {
+
+    return rowCache.getHits();
+  }
+
+  long TSGenerator::getRowCacheMisses() const {
+
+    return rowCache.getMisses();
+  }
+
+  void TSGenerator::setLowerBound(const int segments_in) {
+
+    segments = segments_in;
+  }
+
+  double TSGenerator::getPruningRate() const {
+
+    return boundChecks > 0 ? (double)boundPrunes / boundChecks : 0.0;
+  }
+
+  void TSGenerator::setSeed(const unsigned int seed_in) {
+
+    randomEngine.seed(seed_in);
+    baseTS.seed(seed_in + 1);
+    freePositions.seed(seed_in + 2);
+  }
+
+  double TSGenerator::getTopPairGap() const {
+
+    return topPairGap;
+  }
+
+  void TSGenerator::setCertification(const bool certification_in) {
+
+    certification = certification_in;
+  }
+
+  const certificate &TSGenerator::getCertificate() const {
+
+    return lastCertificate;
+  }
+
+  void TSGenerator::setBudget(const double seconds_in, const int
+      diagonals_in) {
+
+    budgetSeconds = seconds_in;
+    budgetDiagonals = diagonals_in;
+  }
+
   void TSGenerator::calcRunnings(const rseq &sequence_in) {
 
     // obtain running sum and sum of square
-    if (!sums.empty() || !sumSquares.empty()) {
+    runnings = RunningStats(window);
+    runnings.compute(sequence_in);
+
+    sums.resize(runnings.size());
+    sumSquares.resize(runnings.size());
+
+    runnings.getRunnings(0, runnings.size(), sums, sumSquares);
+
+    //the statistics, the whole matrix profile and all distance rows changed
+    stats = SubsequenceStats(window);
+    stats.compute(runnings);
+    stats.computeSegments(sequence_in, segments > 0 ? std::max(1, window
+          / segments) : 0);
+    matrixProfile.invalidate();
+    rowCache.clear();
+    views.clear();
+    viewEdits.clear();
+    boundChecks = 0;
+    boundPrunes = 0;
+  }
 
-      sums.clear();
-      sumSquares.clear();
-    }
+  void TSGenerator::updateRunnings(const rseq &sequence_in, const int pos_in) {
 
-    sums.resize(sequence_in.size() - window + 1);
-    sumSquares.resize(sequence_in.size() - window + 1);
+    //the matrix profile and the distance rows changed around the position
+    matrixProfile.invalidate(pos_in);
+    rowCache.invalidate(pos_in);
 
-    sums[0] = sequence_in[0];
-    sumSquares[0] = sequence_in[0] * sequence_in[0];
+    if (!views.empty())
+      viewEdits.push_back(pos_in);
 
-    for (int i = 1; i < window; i++) {
+    updateRunnings(sequence_in, pos_in, runnings, sums, sumSquares, stats);
+  }
 
-      sums[0] += sequence_in[i];
-      sumSquares[0] += sequence_in[i] * sequence_in[i];
-    }
+  void TSGenerator::updateRunnings(const rseq &sequence_in, const int pos_in,
+      RunningStats &runnings_inout, rseq &sums_inout, rseq &sumSquares_inout,
+      SubsequenceStats &stats_inout) const {
 
-    for (int i = 0; i < (int)sequence_in.size() - window; i++) {
+    //the changed runnings are recomputed exactly from their first subsequence
+    runnings_inout.update(sequence_in, pos_in);
 
-      sums[i + 1] = sums[i] - sequence_in[i] + sequence_in[i + window];
+    runnings_inout.getRunnings(std::max(0, pos_in - window + 1), std::min(
+          runnings_inout.size(), pos_in + window), sums_inout,
+        sumSquares_inout);
 
-      sumSquares[i + 1] = sumSquares[i] - sequence_in[i] * sequence_in[i]
-        + sequence_in[i + window] * sequence_in[i + window];
-    }
+    stats_inout.update(runnings_inout, pos_in);
+    stats_inout.updateSegments(sequence_in, pos_in);
   }
 
-  void TSGenerator::updateRunnings(const rseq &sequence_in, const int pos_in) {
+  void TSGenerator::syncView(const rseq &timeSeries_in, const int view_in,
+      const int pos_in) {
 
-    int start = pos_in - window + 1;
-    int end = pos_in + window - 1;
+    int start = std::max(0, pos_in - window + 1);
+    int end = std::min((int)sums.size(), pos_in + window);
 
-    // check if we need to update the very first sum and sum of squares
-    if (start < 1) {
+    for (int i = 0; i < window; i++)
+      views[view_in][i + pos_in] = timeSeries_in[i + pos_in];
 
-      sums[0] = sequence_in[0];
-      sumSquares[0] = sequence_in[0] * sequence_in[0];
+    for (int i = start; i < end; i++) {
 
-      for (int i = 1; i < window; i++) {
+      viewSums[view_in][i] = sums[i];
+      viewSumSquares[view_in][i] = sumSquares[i];
+    }
 
-        sums[0] += sequence_in[i];
-        sumSquares[0] += sequence_in[i] * sequence_in[i];
-      }
+    viewRunnings[view_in].update(runnings, pos_in);
+    viewStats[view_in].update(viewRunnings[view_in], pos_in);
+    viewStats[view_in].updateSegments(views[view_in], pos_in);
+  }
+
+  void TSGenerator::syncViews(const rseq &timeSeries_in, const int
+      workers_in) {
+
+    //copy everything on first use or if the edits cover the time series
+    if ((int)views.size() != workers_in || views[0].size()
+        != timeSeries_in.size() || viewEdits.size() * window
+        >= timeSeries_in.size()) {
 
-      start = 1;
+      views.assign(workers_in, timeSeries_in);
+      viewRunnings.assign(workers_in, runnings);
+      viewSums.assign(workers_in, sums);
+      viewSumSquares.assign(workers_in, sumSquares);
+      viewStats.assign(workers_in, stats);
     }
+    else
+      ThreadPool::shared().run(workers_in, [&](const int view_in) {
+          for (auto &pos : viewEdits)
+            syncView(timeSeries_in, view_in, pos);
+          });
 
-    // check if we are at the end of the time series
-    if (end > (int)sequence_in.size() - window)
-      end = (int)(sequence_in.size()) - window;
+    viewEdits.clear();
+  }
 
-    // update all changed runnings
-    for (int i = start - 1; i < end; i++) {
+  void TSGenerator::estimateTopPair(const rseq &timeSeries_in, int &pos0_out,
+      int &pos1_out) {
 
-      sums[i + 1] = sums[i] - sequence_in[i] + sequence_in[i + window];
+    if (budgetSeconds <= 0.0 && budgetDiagonals < 1) {
 
-      sumSquares[i + 1] = sumSquares[i] + sequence_in[i + window]
-        * sequence_in[i + window] - sequence_in[i] * sequence_in[i];
+      matrixProfile.topPair(timeSeries_in, stats, pos0_out, pos1_out,
+          threads);
+      return;
     }
+
+    double fraction;
+
+    tpmAnytime(timeSeries_in, stats, pos0_out, pos1_out, budgetSeconds,
+        budgetDiagonals, randomEngine, fraction, threads);
   }
 
   void TSGenerator::generateCustomMotif(rseq &subsequence_out) {
@@ -372,6 +490,13 @@ namespace tsg {
   double TSGenerator::similarity(const rseq &timeSeries_in, const int pos0_in,
       const int pos1_in, const double bestSoFar_in) {
 
+    return similarity(timeSeries_in, stats, pos0_in, pos1_in, bestSoFar_in);
+  }
+
+  double TSGenerator::similarity(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int pos0_in, const int pos1_in, const
+      double bestSoFar_in) {
+
     if (timeSeries_in.empty()) {
 
       std::cerr << "ERROR: Time series is empty!" << std::endl;
@@ -392,34 +517,103 @@ namespace tsg {
       throw(EXIT_FAILURE);
     }
 
-    double rWindow = 1.0 / window;
+    //calculate the similarity
+    return zNormDistance(timeSeries_in.data() + pos0_in, timeSeries_in.data()
+        + pos1_in, window, stats_in.getMean()[pos0_in],
+        stats_in.getRSigma()[pos0_in], stats_in.getMean()[pos1_in],
+        stats_in.getRSigma()[pos1_in], bestSoFar_in);
+  }
+
+  void TSGenerator::visitingOrder(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int pos_in, rseq &zSequence_out, iseq
+      &order_out) const {
+
+    double mean = stats_in.getMean()[pos_in];
+    double rSigma = stats_in.getRSigma()[pos_in];
+
+    zSequence_out.resize(window);
+
+    for (int i = 0; i < window; i++)
+      zSequence_out[i] = (timeSeries_in[pos_in + i] - mean) * rSigma;
+
+    visitingOrder(zSequence_out, order_out);
+  }
 
-    double mean0 = sums[pos0_in] * rWindow;
-    double stdDev0 = sumSquares[pos0_in] * rWindow  - mean0 * mean0;
-    stdDev0 = stdDev0 < 1.0 ? 1.0 : sqrt(stdDev0);
+  void TSGenerator::visitingOrder(const rseq &zSequence_in, iseq &order_out)
+    const {
 
-    double mean1 = sums[pos1_in] * rWindow;
-    double stdDev1 = sumSquares[pos1_in] * rWindow  - mean1 * mean1;
-    stdDev1 = stdDev1 < 1.0 ? 1.0 : sqrt(stdDev1);
+    order_out.resize(zSequence_in.size());
+
+    for (int i = 0; i < (int)order_out.size(); i++)
+      order_out[i] = i;
+
+    //the largest absolute values first
+    std::stable_sort(order_out.begin(), order_out.end(), [&](const int a,
+          const int b) { return std::abs(zSequence_in[a])
+          > std::abs(zSequence_in[b]); });
+  }
+
+  double TSGenerator::similarity(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const rseq &zSequence_in, const iseq
+      &order_in, const int pos_in, const double bestSoFar_in) const {
+
+    double mean = stats_in.getMean()[pos_in];
+    double rSigma = stats_in.getRSigma()[pos_in];
+    const double *subsequence = timeSeries_in.data() + pos_in;
 
     //calculate the similarity
     double sumOfSquares = 0.0;
     double bestSoFar = bestSoFar_in * bestSoFar_in;
-    double norm0;
-    double norm1;
     double diff;
 
     for (int i = 0; i < window && sumOfSquares < bestSoFar; i++) {
 
-      norm0 = (timeSeries_in[pos0_in + i] - mean0) / stdDev0;
-      norm1 = (timeSeries_in[pos1_in + i] - mean1) / stdDev1;
-      diff = norm0 - norm1;
+      diff = (subsequence[order_in[i]] - mean) * rSigma
+        - zSequence_in[order_in[i]];
       sumOfSquares += diff * diff;
     }
 
     return sqrt(sumOfSquares);
   }
 
+  double TSGenerator::prunedSimilarity(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int pos0_in, const rseq
+      &zSequence0_in, const iseq &order0_in, const int pos1_in, const double
+      range_in, long &checks_inout, long &prunes_inout) {
+
+    checks_inout++;
+
+    //the lower bound does not read the time series
+    double lowerBound = stats_in.lowerBound(pos0_in, pos1_in, range_in);
+
+    if (lowerBound > range_in) {
+
+      prunes_inout++;
+      return lowerBound;
+    }
+
+    return similarity(timeSeries_in, stats_in, zSequence0_in, order0_in,
+        pos1_in, range_in);
+  }
+
+  double TSGenerator::prunedSimilarity(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int pos0_in, const int pos1_in, const
+      double range_in, long &checks_inout, long &prunes_inout) {
+
+    checks_inout++;
+
+    //the lower bound does not read the time series
+    double lowerBound = stats_in.lowerBound(pos0_in, pos1_in, range_in);
+
+    if (lowerBound > range_in) {
+
+      prunes_inout++;
+      return lowerBound;
+    }
+
+    return similarity(timeSeries_in, stats_in, pos0_in, pos1_in, range_in);
+  }
+
   void TSGenerator::meanStdDev(const rseq &sequence_in, double &mean_out,
       double &stdDev_out) {
 
@@ -462,26 +656,8 @@ namespace tsg {
       throw(EXIT_FAILURE);
     }
 
-    double rWindow = 1.0 / window;
-
-    double mean = sums[pos_in] * rWindow;
-    double stdDev = sumSquares[pos_in] * rWindow  - mean * mean;
-    stdDev = stdDev < 1.0 ? 1.0 : sqrt(stdDev);
-
-    //calculate the similarity
-    double sumOfSquares = 0.0;
-    double bestSoFar = bestSoFar_in * bestSoFar_in;
-    double norm;
-    double diff;
-
-    for (int i = 0; i < window && sumOfSquares < bestSoFar; i++) {
-
-      norm = (timeSeries_in[pos_in + i] - mean) / stdDev;
-      diff = norm - zMotif[i];
-      sumOfSquares += diff * diff;
-    }
-
-    return sqrt(sumOfSquares);
+    return similarity(timeSeries_in, stats, zMotif, motifOrder, pos_in,
+        bestSoFar_in);
   }
 
   void TSGenerator::calculateSubsequence(rseq &subsequence_out) {
@@ -589,122 +765,555 @@ namespace tsg {
   bool TSGenerator::smallerDistance(const rseq &timeSeries_in, const iseq
       &motifPositions_in, const double similarity_in) {
 
+    return smallerDistance(timeSeries_in, stats, motifPositions_in,
+        similarity_in);
+  }
+
+  bool TSGenerator::smallerDistance(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const iseq &motifPositions_in, const double
+      similarity_in) {
+
     //lower and upper positions of the overlapping subsequences
     int lowerBound = std::max(0, motifPositions_in.back() - window + 1);
     int upperBound = std::min(motifPositions_in.back() + window, length
         - window + 1);
 
+    //the distance profiles of the consecutive overlapping subsequences are
+    //derived from each other and filter the exact similarity, the profile is
+    //only allocated by the sweeps
+    std::optional<DistanceProfile> distanceProfile;
+    rseq profile;
+    double bound = std::numeric_limits<double>::infinity();
+    rseq zSequence;
+    iseq order;
+    long checks = 0;
+    long prunes = 0;
+
+    bool filtered = preferSweep(upperBound - lowerBound, window,
+        similarity_in);
+
+    if (filtered)
+      distanceProfile.emplace(timeSeries_in, stats_in);
 
     //each overlapping subsequence
     for (int i = lowerBound; i < upperBound; i++) {
 
+      if (distanceProfile) {
+
+        distanceProfile->sweep(i, profile);
+        bound = similarity_in * similarity_in + distanceProfile->getError();
+      }
+      else
+        visitingOrder(timeSeries_in, stats_in, i, zSequence, order);
+
       //each subsequence of the time series
       for (int j = 0; j < length - window + 1; j++) {
 
-        //the subsequences are not the injected sequences and non
-        //overlapping
+        //the subsequences are not the injected sequences, non overlapping
+        //and not filtered
         if (!(j == motifPositions_in[0] && i == motifPositions_in[1]) &&
-            abs(i - j) >= window) {
+            abs(i - j) >= window && (!filtered || profile[j] * profile[j]
+              <= bound)) {
 
           //the similarity of both subsequences is smaller than the similarity
-          //of both injected sequences
-          if (similarity(timeSeries_in, i, j, similarity_in) <= similarity_in)
+          //of both injected sequences, the lower bound only pays off without
+          //the distance profile filter
+          if ((distanceProfile ? similarity(timeSeries_in, stats_in, i, j,
+                  similarity_in) : prunedSimilarity(timeSeries_in, stats_in,
+                    i, zSequence, order, j, similarity_in, checks, prunes))
+              <= similarity_in) {
+
+            boundChecks += checks;
+            boundPrunes += prunes;
+
             return true;
+          }
         }
       }
     }
 
+    boundChecks += checks;
+    boundPrunes += prunes;
+
     return false;
   }
 
-  int TSGenerator::largerMotifSet(const rseq &timeSeries_in, const int pos_in,
-      const int size_in, const double range_in) {
+  void TSGenerator::setSizes(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int start_in, const int end_in, const
+      double range_in, iseq &sizes_out) {
 
-    int motif = pos_in;
-    int start = motif - window + 1;
-    int end = motif + window - 1;
+    //the distance profiles of consecutive subsequences are derived from each
+    //other and filter the exact similarity
+    DistanceProfile distanceProfile(timeSeries_in, stats_in);
+    rseq profile(timeSeries_in.size() - window + 1, 0.0);
+    std::shared_ptr<rseq> row;
 
-    if (start < 0)
-      start = 0;
+    for (int i = start_in; i < end_in; i++) {
 
-    if (end > (int)timeSeries_in.size() - window)
-      end = timeSeries_in.size() - window;
+      distanceRow(timeSeries_in, stats_in, i, range_in, &distanceProfile,
+          profile, nullptr, row);
 
-    //collect new matches
-    iseq mats;
+      int size = 1;
 
-    //trivial matches
-    for (int i = start; i <= end; i++)
-      mats.push_back(i);
+      for (int j = 0; j <= (int)timeSeries_in.size() - window; j++)
+        if (abs(j - i) >= window && (*row)[j] <= range_in) {
 
-    //all other matches
-    for (int i = start; i <= end; i++) {
+          //filter overlaps
+          j += window - 1;
+          size++;
+        }
 
-      for (int j = 0; j <= (int)timeSeries_in.size() - window; j++) {
+      sizes_out[i - start_in] = size;
+    }
+  }
 
-        if (similarity(timeSeries_in, i, j, range_in) <= range_in) {
+  void TSGenerator::distanceRow(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int pos_in, const double range_in,
+      DistanceProfile *distanceProfile_in, rseq &profile_inout,
+      DistanceRowCache *cache_in, std::shared_ptr<rseq> &row_out) {
 
-          bool ins = false;
+    int count = (int)timeSeries_in.size() - window + 1;
 
-          for (int k = 0; k < (int)mats.size(); k++) {
+    if (cache_in) {
 
-            if (mats[k] == j) {
+      row_out = cache_in->find(pos_in, range_in);
 
-              ins = true;
-              k = mats.size();
-            }
-            else if (j < mats[k]) {
+      if (row_out)
+        return;
 
-              ins = true;
-              mats.insert(mats.begin() + k, j);
-              k = mats.size();
-            }
-          }
+      //cached rows are shared, hence a new row is needed
+      row_out = std::make_shared<rseq>(count);
+    }
+    else if (!row_out)
+      row_out = std::make_shared<rseq>(count);
+
+    rseq &row = *row_out;
+
+    if (distanceProfile_in) {
+
+      //the distance profile filters the exact similarity, the filtered
+      //subsequences are certainly not within range and the few remaining
+      //ones are computed right away
+      distanceProfile_in->sweep(pos_in, profile_inout);
+
+      double bound = range_in * range_in + distanceProfile_in->getError();
+      double above = std::nextafter(range_in,
+          std::numeric_limits<double>::infinity());
+
+      for (int j = 0; j < count; j++)
+        row[j] = profile_inout[j] * profile_inout[j] <= bound
+          ? similarity(timeSeries_in, stats_in, pos_in, j, range_in) : above;
+    }
+    else
+      std::fill(row.begin(), row.end(), -1.0);
+
+    if (cache_in)
+      cache_in->insert(pos_in, range_in, row_out);
+  }
+
+  void TSGenerator::collectMatches(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int start_in, const int end_in, const
+      double range_in, DistanceRowCache *cache_in, iseq &matches_out) {
+
+    //the distance profiles of consecutive subsequences are derived from each
+    //other and filter the exact similarity, the profile is only allocated by
+    //the sweeps
+    std::optional<DistanceProfile> distanceProfile;
+    rseq profile;
+    std::shared_ptr<rseq> row;
+    rseq zSequence;
+    iseq order;
+    long checks = 0;
+    long prunes = 0;
 
-          if (!ins)
-            mats.push_back(j);
+    if (preferSweep(end_in - start_in, window, range_in))
+      distanceProfile.emplace(timeSeries_in, stats_in);
+
+    for (int i = start_in; i < end_in; i++) {
+
+      distanceRow(timeSeries_in, stats_in, i, range_in, distanceProfile
+          ? &*distanceProfile : nullptr, profile, cache_in, row);
+      order.clear();
+
+      for (int j = 0; j <= (int)timeSeries_in.size() - window; j++) {
+
+        //the similarities of unfiltered rows are computed on first use, the
+        //row may be shared with the cache but no other block uses row i
+        if ((*row)[j] < 0.0) {
+
+          if (order.empty())
+            visitingOrder(timeSeries_in, stats_in, i, zSequence, order);
+
+          (*row)[j] = prunedSimilarity(timeSeries_in, stats_in, i, zSequence,
+              order, j, range_in, checks, prunes);
         }
+
+        if ((*row)[j] <= range_in)
+          matches_out.push_back(j);
       }
     }
 
-    //check matches for larger set motif
+    boundChecks += checks;
+    boundPrunes += prunes;
+  }
+
+  int TSGenerator::largestSet(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const iseq &matches_in, const int begin_in,
+      const int end_in, const int size_in, const double range_in,
+      DistanceRowCache *cache_in, std::atomic<bool> &larger_inout) {
+
+    //the profile is only allocated by the sweeps
+    std::optional<DistanceProfile> distanceProfile;
+    rseq profile;
+    std::shared_ptr<rseq> row;
+    bool sweeping = false;
+    rseq zSequence;
+    iseq order;
     int largestSize = 1;
+    long checks = 0;
+    long prunes = 0;
 
-    for (int i = 0; i < (int)mats.size(); i++) {
+    for (int i = begin_in; i < end_in; i++) {
+
+      //another block found a larger set motif
+      if (larger_inout.load(std::memory_order_relaxed)) {
+
+        boundChecks += checks;
+        boundPrunes += prunes;
+
+        return size_in + 1;
+      }
 
       int size = 1;
 
+      //sweep runs of consecutive matches
+      if (i == begin_in || matches_in[i] != matches_in[i - 1] + 1) {
+
+        int run = 1;
+
+        while (i + run < end_in && matches_in[i + run] == matches_in[i] + run)
+          run++;
+
+        sweeping = preferSweep(run, window, range_in);
+
+        if (sweeping && !distanceProfile)
+          distanceProfile.emplace(timeSeries_in, stats_in);
+      }
+
+      distanceRow(timeSeries_in, stats_in, matches_in[i], range_in, sweeping
+          ? &*distanceProfile : nullptr, profile, cache_in, row);
+      order.clear();
+
       for (int j = 0; j <= (int)timeSeries_in.size() - window; j++) {
 
         //subsequences not overlapping the set motif i
-        if (!(abs(j - mats[i]) < window)) {
+        if (!(abs(j - matches_in[i]) < window)) {
+
+          //the similarities of unfiltered rows are computed on first use,
+          //the row may be shared with the cache but the matches of the
+          //blocks are disjoint, hence no other block uses it
+          if ((*row)[j] < 0.0) {
+
+            if (order.empty())
+              visitingOrder(timeSeries_in, stats_in, matches_in[i],
+                  zSequence, order);
+
+            (*row)[j] = prunedSimilarity(timeSeries_in, stats_in,
+                matches_in[i], zSequence, order, j, range_in, checks, prunes);
+          }
 
           //matching
-          if (similarity(timeSeries_in, mats[i], j, range_in) <= range_in) {
+          if ((*row)[j] <= range_in) {
 
             //filter overlaps
             j += window - 1;
             size++;
 
             //is the set motif larger?
-            if (size > size_in)
+            if (size > size_in) {
+
+              larger_inout.store(true, std::memory_order_relaxed);
+              boundChecks += checks;
+              boundPrunes += prunes;
+
               return size;
+            }
           }
         }
       }
 
-      if (size > largestSize)
-        largestSize = size;
+      if (size > largestSize)
+        largestSize = size;
+    }
+
+    boundChecks += checks;
+    boundPrunes += prunes;
+
+    return largestSize;
+  }
+
+  int TSGenerator::largerMotifSet(const rseq &timeSeries_in, const int pos_in,
+      const int size_in, const double range_in) {
+
+    return largerMotifSet(timeSeries_in, stats, pos_in, size_in, range_in,
+        threads);
+  }
+
+  int TSGenerator::largerMotifSet(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const int pos_in, const int size_in, const
+      double range_in, const int threads_in) {
+
+    int motif = pos_in;
+    int start = motif - window + 1;
+    int end = motif + window - 1;
+
+    if (start < 0)
+      start = 0;
+
+    if (end > (int)timeSeries_in.size() - window)
+      end = timeSeries_in.size() - window;
+
+    int workers = ThreadPool::workers(threads_in);
+
+    //the cache describes the time series of the generator, not the
+    //speculative views
+    DistanceRowCache *cache = &stats_in == &stats ? &rowCache : nullptr;
+
+    //collect new matches, the trivial matches first
+    iseqs matches(workers);
+    int candidates = end - start + 1;
+
+    for (int i = start; i <= end; i++)
+      matches[0].push_back(i);
+
+    //all other matches in contiguous blocks of candidates
+    int blocks = std::min(workers, std::max(1, candidates / 2));
+
+    ThreadPool::shared().run(blocks, [&](const int t) {
+        collectMatches(timeSeries_in, stats_in, start + candidates * t
+            / blocks, start + candidates * (t + 1) / blocks, range_in, cache,
+            matches[t]);
+        });
+
+    //sorted matches without duplicates
+    iseq mats;
+
+    for (auto &block : matches)
+      mats.insert(mats.end(), block.begin(), block.end());
+
+    std::sort(mats.begin(), mats.end());
+    mats.erase(std::unique(mats.begin(), mats.end()), mats.end());
+
+    //check matches for larger set motif in contiguous blocks
+    std::atomic<bool> larger(false);
+    int count = (int)mats.size();
+
+    blocks = std::min(workers, std::max(1, count / 2));
+
+    iseq sizes(blocks, 1);
+
+    ThreadPool::shared().run(blocks, [&](const int t) {
+        sizes[t] = largestSet(timeSeries_in, stats_in, mats, count * t
+            / blocks, count * (t + 1) / blocks, size_in, range_in, cache,
+            larger);
+        });
+
+    //a larger set motif has exactly one subsequence more than size_in
+    if (larger)
+      return size_in + 1;
+
+    return *std::max_element(sizes.begin(), sizes.end());
+  }
+
+  double TSGenerator::injectionOffset(const rseq &timeSeries_in, const int
+      pos_in, const rseq &subsequence_in, const bool clamp_in) const {
+
+    double value = timeSeries_in[pos_in] + timeSeries_in[pos_in + window - 1];
+    value /= 2.0;
+    value -= subsequence_in[0];
+
+    //make sure we are in maxi when maxi can handle the motif height
+    if (clamp_in
+        && method > 3
+        && method < 8
+        && abs(height) <= 2 * maxi) {
+
+      double max = subsequence_in[0];
+      double min = max;
+
+      for (auto &item : subsequence_in) {
+
+        if (item < min)
+          min = item;
+
+        if (item > max)
+          max = item;
+      }
+
+      if (value + max > maxi)
+        value = maxi - max;
+
+      if (value + min < -maxi)
+        value = -maxi - min;
+    }
+
+    return value;
+  }
+
+  int TSGenerator::injectSubsequence(rseq &timeSeries_inout, const rseq
+      &subsequence_in, const bool clamp_in, const int retries_in, const
+      std::function<bool(const rseq &, const SubsequenceStats &, const int,
+        const int)> &accept_in) {
+
+    rseq backup(window, 0.0);
+    double value;
+    int pos;
+
+    //try one position after another in place
+    if (speculation == 1) {
+
+      for (int retry = 0; retry < retries_in; retry++) {
+
+        pos = freePositions.calculateRandomPosition();
+
+        //backup subsequence at position
+        for (int i = 0; i < window; i++)
+          backup[i] = timeSeries_inout[pos + i];
+
+        value = injectionOffset(timeSeries_inout, pos, subsequence_in,
+            clamp_in);
+
+        //inject sequence into the time series
+        for (int i = 0; i < window; i++)
+          timeSeries_inout[i + pos] = value + subsequence_in[i];
+
+        //update the running sum and sum of square
+        updateRunnings(timeSeries_inout, pos);
+
+        if (accept_in(timeSeries_inout, stats, pos, threads))
+          return pos;
+
+        //restore old subsequence
+        for (int i = 0; i < window; i++)
+          timeSeries_inout[pos + i] = backup[i];
+
+        //update the running mean and variance
+        updateRunnings(timeSeries_inout, pos);
+      }
+
+      return -1;
+    }
+
+    int workers = std::min(ThreadPool::workers(threads), speculation);
+
+    //the views of the time series and the runnings, the time series itself
+    //is only written by the commit
+    syncViews(timeSeries_inout, workers);
+
+    iseq candidates;
+
+    for (int tries = 0; tries < retries_in; tries += (int)candidates.size()) {
+
+      //the candidates of this round are drawn in a fixed order and do not
+      //overlap, the committed one is removed by the caller
+      candidates = freePositions.calculateRandomPositions(std::min(
+            speculation, retries_in - tries));
+      freePositions.rollbackPositions();
+
+      //index of the first passing candidate
+      std::atomic<int> first((int)candidates.size());
+
+      auto verify = [&](const int view_in, const int threads_in) {
+
+        rseq &view = views[view_in];
+        double offset;
+        int candidate;
+
+        for (int c = view_in; c < (int)candidates.size(); c += workers) {
+
+          //an earlier candidate passed already
+          if (c > first.load())
+            return;
+
+          candidate = candidates[c];
+
+          offset = injectionOffset(view, candidate, subsequence_in, clamp_in);
+
+          for (int i = 0; i < window; i++)
+            view[i + candidate] = offset + subsequence_in[i];
+
+          updateRunnings(view, candidate, viewRunnings[view_in],
+              viewSums[view_in], viewSumSquares[view_in], viewStats[view_in]);
+
+          if (accept_in(view, viewStats[view_in], candidate, threads_in)) {
+
+            int expected = first.load();
+
+            while (c < expected && !first.compare_exchange_weak(expected, c))
+              ;
+          }
+
+          //restore the view bitwise from the time series
+          syncView(timeSeries_inout, view_in, candidate);
+        }
+      };
+
+      if (workers == 1)
+        verify(0, threads);
+      else
+        ThreadPool::shared().run(workers, [&](const int t) {
+            verify(t, 1);
+            });
+
+      if (first < (int)candidates.size()) {
+
+        //commit the first passing candidate
+        pos = candidates[first];
+        value = injectionOffset(timeSeries_inout, pos, subsequence_in,
+            clamp_in);
+
+        for (int i = 0; i < window; i++)
+          timeSeries_inout[i + pos] = value + subsequence_in[i];
+
+        updateRunnings(timeSeries_inout, pos);
+
+        return pos;
+      }
     }
 
-    return largestSize;
+    return -1;
   }
 
   void TSGenerator::generateMatch(const double range_in, rseq &match_out) {
 
-    //clean output variable
-    if (!match_out.empty())
-      match_out.clear();
+    iseq offsets;
+
+    dispatchWindow(window, [&](auto fixedWindow) {
+        generateMatchKernel<decltype(fixedWindow)::value>(range_in, match_out,
+            offsets);
+      });
+  }
+
+  void TSGenerator::generateMatches(const double range_in, const int count_in,
+      rseqs &matches_out) {
+
+    iseq offsets;
+
+    matches_out.resize(std::max(0, count_in));
+
+    dispatchWindow(window, [&](auto fixedWindow) {
+        for (auto &match : matches_out)
+          generateMatchKernel<decltype(fixedWindow)::value>(range_in, match,
+              offsets);
+      });
+  }
+
+  template <int fixedWindow>
+  void TSGenerator::generateMatchKernel(const double range_in, rseq
+      &match_out, iseq &offsets_inout) {
+
+    //the window size, a compile-time constant for the specialized windows
+    const int window = fixedWindow > 0 ? fixedWindow : this->window;
 
     //reverse window and squared range
     double rw = 1.0 / (double) window;
@@ -712,15 +1321,27 @@ namespace tsg {
 
     //init the match with the motif values
     rseq &s = match_out;
-    s = mMotif;
+    s.assign(mMotif.begin(), mMotif.end());
 
-    //standard deviation of the motif and match
-    double std = 0.0;
+    //running sums of the match, the squared match, the product with the
+    //z-normalized motif and the sums of the z-normalized motif
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    double cross = 0.0;
+    double zSum = 0.0;
+    double zSumSquares = 0.0;
 
-    for (auto & v : s)
-      std += v * v;
+    for (int j = 0; j < window; j++) {
+
+      sum += s[j];
+      sumSquares += s[j] * s[j];
+      cross += zMotif[j] * s[j];
+      zSum += zMotif[j];
+      zSumSquares += zMotif[j] * zMotif[j];
+    }
 
-    std = std * rw;
+    //standard deviation of the motif and match
+    double std = sumSquares * rw;
 
     if (std > 1.0)
       std = sqrt(std);
@@ -730,21 +1351,26 @@ namespace tsg {
     //compute the range per offset
     double r = std * range_in * sqrt(rw);
 
-    //mean of the match
-    double m = 0.0;
+    //choose motif offsets randomly
+    offsets_inout.resize(window);
 
-    for (auto & v : s)
-      m += v;
+    for (int i = 0; i < window; i++)
+      offsets_inout[i] = i;
 
-    m *= rw;
+    std::shuffle(offsets_inout.begin(), offsets_inout.end(), randomEngine);
 
-    //choose motif offsets randomly
-    rseq u;
+    //the shift of all values, which is subtracted at the end
+    double shift = 0.0;
 
-    for (int i = 0; i < window; i++)
-      u.push_back(i);
+    //variables for the mean update, the perturbed value and its change
+    double m;
+    double value;
+    double delta;
 
-    std::random_shuffle(u.begin(), u.end());
+    //backup of the running sums
+    double sumBackup;
+    double sumSquaresBackup;
+    double crossBackup;
 
     //variable for the z-normalized Euclidean distance
     double d;
@@ -757,6 +1383,8 @@ namespace tsg {
 
     for (int i = 0; i < window; i++) {
 
+      int k = offsets_inout[i];
+
       //compute noise
       n = noise(randomEngine);
 
@@ -764,48 +1392,52 @@ namespace tsg {
       if (i % 2 == 1)
         n = -n;
 
-      if (0.0 < s[u[i]])
-        s[u[i]] -= n;
-      else
-        s[u[i]] += n;
+      value = s[k] - shift;
+      delta = 0.0 < value ? -n : n;
 
-      //update mean and standard deviation of the match
-      m = n * rw;
+      s[k] += delta;
 
-      std = 0.0;
+      sumBackup = sum;
+      sumSquaresBackup = sumSquares;
+      crossBackup = cross;
 
-      for (auto & v : s)
-        std += v * v - m * m;
+      sum += delta;
+      sumSquares += (2.0 * value + delta) * delta;
+      cross += zMotif[k] * delta;
+
+      //update mean and standard deviation of the match
+      m = n * rw;
 
-      std = std * rw;
+      std = sumSquares * rw - m * m;
 
       if (std > 1.0)
         std = 1.0 / sqrt(std);
       else
         std = 1.0;
 
-      //compute distance
-      d = 0.0;
-
-      for (int j = 0; j < window; j++) {
-
-        d += (zMotif[j] - (s[j] - m) * std) * (zMotif[j] - (s[j] - m) * std);
-
-        if (d >= rs)
-          break;
-      }
+      //compute distance from the running sums, i.e., the expansion of the
+      //sum of (zMotif[j] - (s[j] - m) * std)^2
+      d = zSumSquares - 2.0 * std * (cross - m * zSum) + std * std
+        * (sumSquares - 2.0 * m * sum + window * m * m);
 
       if (d >= rs) {
 
-        s[u[i]] -= n;
-        return;
+        s[k] -= delta;
+        sum = sumBackup;
+        sumSquares = sumSquaresBackup;
+        cross = crossBackup;
+        break;
       }
-      else {
 
-        for (auto &v : s)
-          v -= m;
-      }
+      //shift all values lazily
+      shift += m;
+      sumSquares += (window * m - 2.0 * sum) * m;
+      sum -= window * m;
+      cross -= m * zSum;
     }
+
+    for (int j = 0; j < window; j++)
+      s[j] -= shift;
   }
 
   void TSGenerator::mzNormMotif(const rseq &motif_in) {
@@ -842,6 +1474,8 @@ namespace tsg {
       mMotif.push_back(motif_in[i] - m);
       zMotif.push_back(mMotif[i] * s);
     }
+
+    visitingOrder(zMotif, motifOrder);
   }
 
   void TSGenerator::injectPairMotif(rseq &timeSeries_out, rseqs &motif_out) {
@@ -868,11 +1502,8 @@ namespace tsg {
     int pos0 = -1;
     int pos1 = -1;
     rseq motif;
-    rseq backup;
-    backup.resize(window);
     double d;
     double value;
-    double min, max;
     int retries = 20;
 
     //generate a base time series
@@ -883,7 +1514,7 @@ namespace tsg {
 
     //determine simlarity of the top motif pair in the random synthetic time
     //series
-    tpm(timeSeries_out, sums, sumSquares, pos0, pos1, window);
+    estimateTopPair(timeSeries_out, pos0, pos1);
     d = similarity(timeSeries_out, pos0, pos1);
 
     //compute first pair motif sequence
@@ -904,44 +1535,18 @@ namespace tsg {
     freePositions.removePosition();
 
     //inject sequence into the time series
-    value = timeSeries_out[pos0] + timeSeries_out[pos0 + window - 1];
-    value /= 2.0;
-    value -= motif[0];
-
-    //make sure we are in maxi when maxi can handle the motif height
-    if (method > 3
-        && method < 8
-        && abs(height) <= 2 * maxi) {
-
-      max = motif[0];
-      min = max;
-
-      for (auto &item : motif) {
-
-        if (item < min)
-          min = item;
-
-        if (item > max)
-          max = item;
-      }
-
-      if (value + max > maxi)
-        value = maxi - max;
-
-      if (value + min < -maxi)
-        value = -maxi - min;
-    }
+    value = injectionOffset(timeSeries_out, pos0, motif, true);
 
     for (int i = 0; i < window; i++)
       timeSeries_out[i + pos0] = value + motif[i];
 
-    //compute running mean and std dev
-    calcRunnings(timeSeries_out);
+    //update the running sum and sum of square
+    updateRunnings(timeSeries_out, pos0);
 
     //determine simlarity of the top pair motif in the random synthetic time
     //series
     value = pos0;
-    tpm(timeSeries_out, sums, sumSquares, pos0, pos1, window);
+    estimateTopPair(timeSeries_out, pos0, pos1);
     d = similarity(timeSeries_out, pos0, pos1);
     pos0 = value;
 
@@ -950,70 +1555,19 @@ namespace tsg {
 
     motif_out[1] = motif;
 
-    //get a random position for the second motif sequence
-    pos1 = freePositions.calculateRandomPosition();
-
-    for(int i = 0; i <= retries; i++) {
+    //inject the second motif sequence at a position without a better pair
+    //motif
+    pos1 = injectSubsequence(timeSeries_out, motif, true, retries + 1,
+        [&](const rseq &timeSeries_in, const SubsequenceStats &stats_in, const
+          int pos_in, const int) {
+        return !smallerDistance(timeSeries_in, stats_in, { pos0, pos_in },
+            similarity(timeSeries_in, stats_in, pos0, pos_in)); });
 
-      if(i == length) {
+    if (pos1 < 0) {
 
-        std::cerr << "ERROR: Cannot inject second pair motif sequence!" <<
-          std::endl;
-        throw(EXIT_FAILURE);
-      }
-
-      for (int i = 0; i < window; i++)
-        backup[i] = timeSeries_out[i + pos1];
-
-      //inject the second motif sequence
-      value = backup[0] + backup.back();
-      value /= 2.0;
-      value -= motif[0];
-
-      //make sure we are in maxi when maxi can handle the motif height
-      if (method > 3
-        && method < 8
-        && abs(height) <= 2 * maxi) {
-
-        max = motif[0];
-        min = max;
-
-        for (auto &item : motif) {
-
-          if (item < min)
-            min = item;
-
-          if (item > max)
-            max = item;
-        }
-
-        if (value + max > maxi)
-          value = maxi - max;
-
-        if (value + min < -maxi)
-          value = -maxi - min;
-      }
-
-      for (int i = 0; i < window; i++)
-        timeSeries_out[i + pos1] = value + motif[i];
-
-      //update the runnings
-      updateRunnings(timeSeries_out, pos1);
-
-      //check for success
-      if(!smallerDistance(timeSeries_out, { pos0, pos1 },
-            similarity(timeSeries_out, pos0, pos1)))
-        break;
-
-      //reset time series
-      for (int i = 0; i < window; i++)
-        timeSeries_out[i + pos1] = backup[i];
-
-      //update the runnings
-      updateRunnings(timeSeries_out, pos1);
-
-      //get new random position for the second motif sequence
-      pos1 = freePositions.calculateRandomPosition();
+      std::cerr << "ERROR: Cannot inject second pair motif sequence!" <<
+        " Retry or change your settings!" << std::endl;
+      throw(EXIT_FAILURE);
     }
   }
 
@@ -1040,10 +1594,8 @@ namespace tsg {
     int pos0 = -1;
     int pos1 = -1;
     rseq motif;
-    rseq backup(window, 0.0);
     double d;
     double value;
-    double min, max;
     int retries = 20;
 
     //generate a base time series and get the top pair motif distance
@@ -1052,7 +1604,7 @@ namespace tsg {
     //compute running mean and std dev
     calcRunnings(timeSeries_out);
 
-    tpm(timeSeries_out, sums, sumSquares, pos0, pos1, window);
+    estimateTopPair(timeSeries_out, pos0, pos1);
     d = similarity(timeSeries_out, pos0, pos1);
 
     //init a base motif sequence
@@ -1075,33 +1627,7 @@ namespace tsg {
     pos_out[0].push_back(pos0);
 
     //inject sequence into the time series
-    value = timeSeries_out[pos0] + timeSeries_out[pos0 + window - 1];
-    value /= 2.0;
-    value -= motif[0];
-
-    //make sure we are in maxi when maxi can handle the motif height
-    if (method > 3
-        && method < 8
-        && abs(height) <= 2 * maxi) {
-
-      max = motif[0];
-      min = max;
-
-      for (auto &item : motif) {
-
-        if (item < min)
-          min = item;
-
-        if (item > max)
-          max = item;
-      }
-
-      if (value + max > maxi)
-        value = maxi - max;
-
-      if (value + min < -maxi)
-        value = -maxi - min;
-    }
+    value = injectionOffset(timeSeries_out, pos0, motif, true);
 
     //inject sequence values
     for (int i = 0; i < window; i++)
@@ -1112,97 +1638,50 @@ namespace tsg {
 
     //determine similarity of the top motif pair in the random synthetic time
     //series
-    tpm(timeSeries_out, sums, sumSquares, pos0, pos1, window);
+    estimateTopPair(timeSeries_out, pos0, pos1);
     d = 0.9999999 * similarity(timeSeries_out, pos0, pos1);
 
+    //generate the matches of the set ...
+    rseqs matches;
+    generateMatches(d, size - 1, matches);
+
     //inject sequences into the time series
     for (int motifItr = 1; motifItr < size; motifItr++) {
 
-      //compute the random position for the subsequence
-      pos0 = freePositions.calculateRandomPosition();
-
-      pos_out[0].push_back(pos0);
-
-      //generate next match ...
-      generateMatch(d, motif);
+      //next match ...
+      motif = matches[motifItr - 1];
 
       //try to inject another sequence
-      for (int retry = 0; retry <= retries; retry++) {
-
-        if (retry == retries) {
-
-          std::cerr << "ERROR: Cannot add another set motif subsequence!" <<
-            " Retry or change your settings!" << std::endl;
-          throw(EXIT_FAILURE);
-        }
-
-        //backup subsequence at position
-        for (int i = 0; i < window; i++)
-          backup[i] = timeSeries_out[pos0 + i];
-
-        value = backup[0] + backup.back();
-        value /= 2.0;
-        value -= motif[0];
-
-        //make sure we are in maxi when maxi can handle the motif height
-        if (method > 3
-            && method < 8
-            && abs(height) <= 2 * maxi) {
-
-          max = motif[0];
-          min = max;
-
-          for (auto &item : motif) {
+      int count = (int)pos_out[0].size() + 1;
 
-            if (item < min)
-              min = item;
+      pos0 = injectSubsequence(timeSeries_out, motif, true, retries, [&](const
+            rseq &timeSeries_in, const SubsequenceStats &stats_in, const int
+            pos_in, const int threads_in) {
+          return largerMotifSet(timeSeries_in, stats_in, pos_in, count, d,
+              threads_in) <= count; });
 
-            if (item > max)
-              max = item;
-          }
-
-          if (value + max > maxi)
-            value = maxi - max;
-
-          if (value + min < -maxi)
-            value = -maxi - min;
-        }
-
-        //inject sequence into the time series
-        for (int i = 0; i < window; i++)
-          timeSeries_out[i + pos0] = value + motif[i];
-
-        //update the running sum and sum of square
-        updateRunnings(timeSeries_out, pos0);
-
-        if (largerMotifSet(timeSeries_out, pos0, pos_out[0].size(), d) <=
-            (int)pos_out[0].size())
-          break;
-
-        //restore old subsequence
-        for (int i = 0; i < window; i++)
-          timeSeries_out[pos0 + i] = backup[i];
-
-        //update the running mean and variance
-        updateRunnings(timeSeries_out, pos0);
-
-        //get new random position in the synthetic time series
-        pos0 = freePositions.calculateRandomPosition();
+      if (pos0 < 0) {
 
-        pos_out[0].back() = pos0;
+        std::cerr << "ERROR: Cannot add another set motif subsequence!" <<
+          " Retry or change your settings!" << std::endl;
+        throw(EXIT_FAILURE);
       }
 
+      pos_out[0].push_back(pos0);
+
       //remove the position from available positions
-      freePositions.removePosition();
+      freePositions.removePosition(pos0);
     }
 
     pos0 = pos_out[0][0];
 
-    d = similarityWithMotif(timeSeries_out, pos_out[0][1], d);
+    //the range is the exact largest similarity to the center, early
+    //abandoned similarities would underestimate it
+    d = 0.0;
 
-    for (int i = 2; i < (int)pos_out[0].size(); i++) {
+    for (int i = 1; i < (int)pos_out[0].size(); i++) {
 
-      value = similarity(timeSeries_out, pos0, pos_out[0][i], d);
+      value = similarity(timeSeries_out, pos0, pos_out[0][i]);
 
       if (value > d)
         d = value;
@@ -1239,57 +1718,21 @@ namespace tsg {
       //harden the time series by injecting smaller motif
       for (int motifItr = 1; motifItr < size - 1; motifItr++) {
 
-        //compute the random position for the subsequence
-        pos0 = freePositions.calculateRandomPosition();
-
-        //try to inject another sequence
-        for (int retry = 0; retry <= retries; retry++) {
-
-          if (retry == retries) {
-
-            std::cerr << "ERROR: Cannot add smaller motif set subsequence!" <<
-              " Retry or change your settings!" << std::endl;
-            throw(EXIT_FAILURE);
-          }
-
-          //backup subsequence at position
-          for (int i = 0; i < window; i++)
-            backup[i] = timeSeries_out[pos0 + i];
-
-          value = backup[0] + backup.back();
-          value /= 2.0;
-          value -= sec[0];
-
-          //inject sequence into the time series
-          for (int i = 0; i < window; i++)
-            timeSeries_out[i + pos0] = value + sec[i];
-
-          //update the running sum and sum of square
-          updateRunnings(timeSeries_out, pos0);
-
-          secSize = largerMotifSet(timeSeries_out, pos0, size - 1, d);
-
-          if (secSize < size) {
-
-            if (secSize >= size - 1)
-              retry = retries;
-
-            break;
-          }
-
-          //restore old subsequence
-          for (int i = 0; i < window; i++)
-            timeSeries_out[pos0 + i] = backup[i];
+        pos0 = injectSubsequence(timeSeries_out, sec, false, retries, [&](
+              const rseq &timeSeries_in, const SubsequenceStats &stats_in,
+              const int pos_in, const int threads_in) {
+            return largerMotifSet(timeSeries_in, stats_in, pos_in, size - 1,
+                d, threads_in) < size; });
 
-          //update the running mean and variance
-          updateRunnings(timeSeries_out, pos0);
+        if (pos0 < 0) {
 
-          //get new random position in the synthetic time series
-          pos0 = freePositions.calculateRandomPosition();
+          std::cerr << "ERROR: Cannot add smaller motif set subsequence!" <<
+            " Retry or change your settings!" << std::endl;
+          throw(EXIT_FAILURE);
         }
 
         //remove the position from available positions
-        freePositions.removePosition();
+        freePositions.removePosition(pos0);
       }
     }
   }
@@ -1317,10 +1760,8 @@ namespace tsg {
     int pos0 = -1;
     int pos1 = -1;
     rseq motif;
-    rseq backup(window, 0.0);
     double d;
     double value;
-    double min, max;
     int retries = 20;
 
     //generate a base time series
@@ -1331,7 +1772,7 @@ namespace tsg {
 
     //determine similarity of the top motif pair in the random synthetic time
     //series
-    tpm(timeSeries_out, sums, sumSquares, pos0, pos1, window);
+    estimateTopPair(timeSeries_out, pos0, pos1);
     d = 0.49999999 * similarity(timeSeries_out, pos0, pos1);
 
     //calculate motif set center subsequence in the window size dimentional
@@ -1349,92 +1790,46 @@ namespace tsg {
     //update z-normalize motif
     mzNormMotif(motif);
 
+    //generate the matches of the set ...
+    rseqs matches;
+    generateMatches(d, size, matches);
+
     //inject sequences into the time series
     for (int motifItr = 0; motifItr < size; motifItr++) {
 
-      //compute the random position for the subsequence
-      pos0 = freePositions.calculateRandomPosition();
-
-      pos_out[0].push_back(pos0);
-
-      //generate next match ...
-      generateMatch(d, motif);
+      //next match ...
+      motif = matches[motifItr];
 
       //try to inject another sequence
-      for (int retry = 0; retry <= retries; retry++) {
-
-        if (retry == retries) {
-
-          std::cerr << "ERROR: Cannot add another latent motif subsequence!" <<
-            " Retry or change your settings!" << std::endl;
-          throw(EXIT_FAILURE);
-        }
-
-        //backup subsequence at position
-        for (int i = 0; i < window; i++)
-          backup[i] = timeSeries_out[pos0 + i];
-
-        value = backup[0] + backup.back();
-        value /= 2.0;
-        value -= motif[0];
-
-        //make sure we are in maxi when maxi can handle the motif height
-        if (method > 3
-            && method < 8
-            && abs(height) <= 2 * maxi) {
-
-          max = motif[0];
-          min = max;
-
-          for (auto &item : motif) {
-
-            if (item < min)
-              min = item;
-
-            if (item > max)
-              max = item;
-          }
-
-          if (value + max > maxi)
-            value = maxi - max;
-
-          if (value + min < -maxi)
-            value = -maxi - min;
-        }
-
-        //inject sequence into the time series
-        for (int i = 0; i < window; i++)
-          timeSeries_out[i + pos0] = value + motif[i];
-
-        //update the running sum and sum of square
-        updateRunnings(timeSeries_out, pos0);
-
-        if (largerMotifSet(timeSeries_out, pos0, pos_out[0].size(), 2.0 * d) <=
-            (int)pos_out[0].size())
-          break;
-
-        //restore old subsequence
-        for (int i = 0; i < window; i++)
-          timeSeries_out[pos0 + i] = backup[i];
+      int count = (int)pos_out[0].size() + 1;
 
-        //update the running mean and variance
-        updateRunnings(timeSeries_out, pos0);
+      pos0 = injectSubsequence(timeSeries_out, motif, true, retries, [&](const
+            rseq &timeSeries_in, const SubsequenceStats &stats_in, const int
+            pos_in, const int threads_in) {
+          return largerMotifSet(timeSeries_in, stats_in, pos_in, count, 2.0 * d,
+              threads_in) <= count; });
 
-        //get new random position in the synthetic time series
-        pos0 = freePositions.calculateRandomPosition();
+      if (pos0 < 0) {
 
-        pos_out[0].back() = pos0;
+        std::cerr << "ERROR: Cannot add another latent motif subsequence!" <<
+          " Retry or change your settings!" << std::endl;
+        throw(EXIT_FAILURE);
       }
 
+      pos_out[0].push_back(pos0);
+
       //remove the position from available positions
-      freePositions.removePosition();
+      freePositions.removePosition(pos0);
     }
 
-    d = similarityWithMotif(timeSeries_out, pos_out[0][0], d);
+    //the range is the exact largest similarity to the latent motif, early
+    //abandoned similarities would underestimate it
+    d = 0.0;
 
-    for (int i = 1; i < (int)pos_out[0].size(); i++) {
+    for (int i = 0; i < (int)pos_out[0].size(); i++) {
 
-      value = similarityWithMotif(timeSeries_out, pos_out[0][i], d);
+      value = similarityWithMotif(timeSeries_out, pos_out[0][i],
+          std::numeric_limits<double>::max());
 
       if (value > d)
         d = value;
@@ -1470,61 +1865,133 @@ namespace tsg {
       //harden the time series by injecting smaller motif
       for (int motifItr = 1; motifItr < size - 1; motifItr++) {
 
-        //compute the random position for the subsequence
-        pos0 = freePositions.calculateRandomPosition();
+        pos0 = injectSubsequence(timeSeries_out, sec, false, retries, [&](
+              const rseq &timeSeries_in, const SubsequenceStats &stats_in,
+              const int pos_in, const int threads_in) {
+            return largerMotifSet(timeSeries_in, stats_in, pos_in, size - 1,
+                2.0 * d, threads_in) < size; });
 
-        //try to inject another sequence
-        for (int retry = 0; retry <= retries; retry++) {
+        if (pos0 < 0) {
 
-          if (retry == retries) {
+          std::cerr << "ERROR: Cannot add smaller motif set subsequence!" <<
+            " Retry or change your settings!" << std::endl;
+          throw(EXIT_FAILURE);
+        }
 
-            std::cerr << "ERROR: Cannot add smaller motif set subsequence!" <<
-              " Retry or change your settings!" << std::endl;
-            throw(EXIT_FAILURE);
-          }
+        //remove the position from available positions
+        freePositions.removePosition(pos0);
+      }
+    }
+  }
 
-          //backup subsequence at position
-          for (int i = 0; i < window; i++)
-            backup[i] = timeSeries_out[pos0 + i];
+  certificate TSGenerator::certify(const rseq &timeSeries_in, const rseq
+      &d_in, const iseqs &pos_in, const double tolerance_in) {
 
-          value = backup[0] + backup.back();
-          value /= 2.0;
-          value -= sec[0];
+    if ((int)timeSeries_in.size() != length) {
 
-          //inject sequence into the time series
-          for (int i = 0; i < window; i++)
-            timeSeries_out[i + pos0] = value + sec[i];
+      std::cerr << "ERROR: Time series length " << timeSeries_in.size() <<
+        " does not match the generator!" << std::endl;
+      throw(EXIT_FAILURE);
+    }
 
-          //update the running sum and sum of square
-          updateRunnings(timeSeries_out, pos0);
+    //local statistics, the ones of the generator stay untouched
+    RunningStats localRunnings(window);
+    SubsequenceStats localStats(window);
 
-          secSize = largerMotifSet(timeSeries_out, pos0, size - 1, 2.0 * d);
+    localRunnings.compute(timeSeries_in);
+    localStats.compute(localRunnings);
 
-          if (secSize < size) {
+    return certify(timeSeries_in, localStats, d_in, pos_in, tolerance_in);
+  }
 
-            if (secSize >= size - 1)
-              retry = retries;
+  certificate TSGenerator::certify(const rseq &timeSeries_in, const
+      SubsequenceStats &stats_in, const rseq &d_in, const iseqs &pos_in,
+      const double tolerance_in) {
 
-            break;
-          }
-          else {
+    if (d_in.empty() || pos_in.empty() || pos_in[0].empty()) {
 
-            //restore old subsequence
-            for (int i = 0; i < window; i++)
-              timeSeries_out[pos0 + i] = backup[i];
+      std::cerr << "ERROR: Missing ground truth to certify!" << std::endl;
+      throw(EXIT_FAILURE);
+    }
 
-            //update the running mean and variance
-            updateRunnings(timeSeries_out, pos0);
+    auto begin = std::chrono::steady_clock::now();
 
-            //get new random position in the synthetic time series
-            pos0 = freePositions.calculateRandomPosition();
-          }
-        }
+    certificate cert;
 
-        //remove the position from available positions
-        freePositions.removePosition();
-      }
+    //the range verified by the inject routine
+    cert.range = gen == 2 ? 2.0 * d_in[0] : d_in[0];
+
+    double range = cert.range * (1.0 + tolerance_in);
+
+    //the exact set motif size of each subsequence in contiguous blocks
+    int count = length - window + 1;
+    int blocks = std::min(ThreadPool::workers(threads), count);
+    iseq sizes(count, 1);
+
+    if (blocks == 1)
+      setSizes(timeSeries_in, stats_in, 0, count, range, sizes);
+    else {
+
+      std::vector<iseq> blockSizes(blocks);
+
+      ThreadPool::shared().run(blocks, [&](const int t) {
+          int start = count * t / blocks;
+          int end = count * (t + 1) / blocks;
+
+          blockSizes[t].resize(end - start);
+          setSizes(timeSeries_in, stats_in, start, end, range,
+              blockSizes[t]);
+          });
+
+      for (int t = 0; t < blocks; t++)
+        std::copy(blockSizes[t].begin(), blockSizes[t].end(), sizes.begin()
+            + count * t / blocks);
     }
+
+    //the first largest set motif, an injected subsequence if one is largest
+    cert.center = (int)(std::max_element(sizes.begin(), sizes.end())
+        - sizes.begin());
+    cert.largest = sizes[cert.center];
+
+    for (auto &pos : pos_in[0])
+      if (pos >= 0 && pos < count && sizes[pos] == cert.largest) {
+
+        cert.center = pos;
+        break;
+      }
+
+    //the subsequences of the largest set motif
+    DistanceProfile distanceProfile(timeSeries_in, stats_in);
+    rseq profile(count, 0.0);
+    std::shared_ptr<rseq> row;
+    iseq members(1, cert.center);
+
+    distanceRow(timeSeries_in, stats_in, cert.center, range,
+        &distanceProfile, profile, nullptr, row);
+
+    for (int j = 0; j < count; j++)
+      if (abs(j - cert.center) >= window && (*row)[j] <= range) {
+
+        members.push_back(j);
+        j += window - 1;
+      }
+
+    //the largest set motif not overlapping the largest one
+    for (int i = 0; i < count; i++)
+      if (sizes[i] > cert.runnerUp && std::all_of(members.begin(),
+            members.end(), [&](const int member) {
+            return abs(i - member) >= window; }))
+        cert.runnerUp = sizes[i];
+
+    cert.margin = cert.largest - cert.runnerUp;
+    cert.confirmed = cert.largest == (gen ? (int)pos_in[0].size() : 2)
+      && cert.margin > 0 && std::find(pos_in[0].begin(), pos_in[0].end(),
+          cert.center) != pos_in[0].end();
+
+    cert.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    return cert;
   }
 
   void TSGenerator::run(rseq &timeSeries_out, rseqs &motif_out, rseq &d_out,
@@ -1564,15 +2031,28 @@ namespace tsg {
     }
 
 
-    //add top motif pair to output
-    int positionOne = 0;
-    int positionTwo = 0;
+    //add top motif pair to output, the exact second non overlapping pair
+    //yields the gap
+    iseq pos0s;
+    iseq pos1s;
+    rseq ds;
+
+    tpmTopK(timeSeries_out, stats, 2, pos0s, pos1s, ds, threads);
+
+    int positionOne = pos0s[0];
+    int positionTwo = pos1s[0];
+
+    topPairGap = ds.size() > 1 ? ds[1] - ds[0]
+      : std::numeric_limits<double>::infinity();
 
-    tpm(timeSeries_out, sums, sumSquares, positionOne, positionTwo, window);
     d_out.push_back(similarity(timeSeries_out, positionOne, positionTwo,
         std::numeric_limits<double>::max()));
 
     pos_out[gen ? 1 : 0].push_back(positionOne);
     pos_out[gen ? 1 : 0].push_back(positionTwo);
+
+    //certify the ground truth, timed separately
+    lastCertificate = certification ? certify(timeSeries_out, stats, d_out,
+        pos_out, defaultTolerance) : certificate();
   }
 }
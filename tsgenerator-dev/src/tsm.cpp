@@ -12,7 +12,8 @@ namespace tsg {
 
   TSM::TSM(const rseq &timeSeries_in, const rseq &sums_in, const rseq
       &sumSquares_in) : timeSeries(timeSeries_in), sums(sums_in),
-      sumSquares(sumSquares_in) {
+      sumSquares(sumSquares_in), stats((int)(timeSeries_in.size()
+            - sums_in.size()) + 1, sums_in, sumSquares_in) {
 
     if (timeSeries_in.empty()) {
 
@@ -42,20 +43,11 @@ namespace tsg {
       paa_out.resize(0);
     }
 
-    double rW = 1.0 / (double)window_in;
     double c = (double)window_in / (double)paa_in;
     double rC = (double)paa_in / (double)window_in;
     double s = 0.0;
-    double mean = rW * sums[pos_in];
-    double sig = (rW * (sumSquares[pos_in] - rW * (sums[pos_in]
-            * sums[pos_in])));
-
-    if (sig < 1.0)
-      sig = 1.0;
-    else
-      sig = sqrt(sig);
-
-    double rSig = 1.0 / sig;
+    double mean = stats.getMean()[pos_in];
+    double rSig = stats.getRSigma()[pos_in];
     double rCrS = rC * rSig;
 
     for (int i = 0; i < paa_in; i++) {
@@ -222,31 +214,11 @@ namespace tsg {
       throw(EXIT_FAILURE);
     }
 
-    double rWindow = 1.0 / (double)window;
-
-    double mean0 = sums[pos0_in] * rWindow;
-    double stdDev0 = sumSquares[pos0_in] * rWindow  - mean0 * mean0;
-    stdDev0 = stdDev0 < 1.0 ? 1.0 : sqrt(stdDev0);
-
-    double mean1 = sums[pos1_in] * rWindow;
-    double stdDev1 = sumSquares[pos1_in] * rWindow  - mean1 * mean1;
-    stdDev1 = stdDev1 < 1.0 ? 1.0 : sqrt(stdDev1);
-
     //compute the distance
-    double dist = 0.0;
-    double norm0;
-    double norm1;
-    double diff;
-
-    for (int i = 0; i < window; i++) {
-
-      norm0 = (timeSeries[pos0_in + i] - mean0) / stdDev0;
-      norm1 = (timeSeries[pos1_in + i] - mean1) / stdDev1;
-      diff = norm0 - norm1;
-      dist += diff * diff;
-    }
-
-    return sqrt(dist);
+    return zNormDistance(timeSeries.data() + pos0_in, timeSeries.data()
+        + pos1_in, window, stats.getMean()[pos0_in],
+        stats.getRSigma()[pos0_in], stats.getMean()[pos1_in],
+        stats.getRSigma()[pos1_in]);
   }
 
   double TSM::distADM(const int i_in, const int j_in) {
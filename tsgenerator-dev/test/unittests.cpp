@@ -184,6 +184,78 @@ void test_freepositions() {
     }
   }
 
+  { //test the positions and counts against a bitmap
+
+    auto length = 1000;
+    auto window = 7;
+    tsg::FreePositions freePos(length, window);
+    std::vector<bool> bitmap(length - window + 1, true);
+    bool valid = true;
+
+    freePos.seed(11);
+    TEST_R(freePos.getFreeCount() == length - window + 1);
+
+    while (freePos.getFreeCount() > 0) {
+
+      int pos = freePos.calculateRandomPosition();
+
+      if (!bitmap[pos])
+        valid = false;
+
+      freePos.removePosition();
+
+      for (int i = std::max(0, pos - 2 * window + 1); i < std::min(
+            (int)bitmap.size(), pos + 2 * window); i++)
+        bitmap[i] = false;
+
+      if (freePos.getFreeCount() != std::count(bitmap.begin(), bitmap.end(),
+            true))
+        valid = false;
+    }
+
+    TEST_R(valid);
+  }
+
+  { //test the batch of positions with commit and rollback
+
+    auto length = 200;
+    auto window = 5;
+    tsg::FreePositions freePos(length, window);
+    tsg::iseq batch;
+    bool apart = true;
+
+    freePos.seed(3);
+    batch = freePos.calculateRandomPositions(4);
+    TEST_R(batch.size() == 4);
+
+    for (int i = 0; i < (int)batch.size(); i++)
+      for (int j = 0; j < i; j++)
+        if (abs(batch[i] - batch[j]) < 2 * window)
+          apart = false;
+
+    TEST_R(apart);
+    TEST_R(freePos.getFreeCount() < length - window + 1);
+
+    freePos.rollbackPositions();
+    TEST_R(freePos.getFreeCount() == length - window + 1);
+
+    //the batch is drawn again with the same seed
+    freePos.seed(3);
+    TEST_R(freePos.calculateRandomPositions(4) == batch);
+
+    int count = freePos.getFreeCount();
+
+    freePos.commitPositions();
+    freePos.rollbackPositions();
+    TEST_R(freePos.getFreeCount() == count);
+
+    //the batch stops when the free positions run out
+    batch = freePos.calculateRandomPositions(1000);
+    freePos.commitPositions();
+    TEST_R(freePos.getFreeCount() == 0);
+    TEST_R(0 < (int)batch.size() && (int)batch.size() < 1000);
+  }
+
   { //test failure
     auto length = 3;
     auto window = 3;
@@ -259,215 +331,1449 @@ void test_basets() {
   baseTS.simpleRandomWalk(ts, 23, 1.0, 0.1);
   TEST_R(ts.size() == 23);
 
-  baseTS.simpleRandomWalk(ts, 0, 1.0, 0.1);
-  TEST_R(ts.size() == 0);
+  baseTS.simpleRandomWalk(ts, 0, 1.0, 0.1);
+  TEST_R(ts.size() == 0);
+
+  //bounded real random walk
+  baseTS.realRandomWalk(ts, 100, 1.0, 20.0, 0.0);
+  TEST_R(ts.size() == 100);
+
+  baseTS.realRandomWalk(ts, 23, 1.0, 20.0, 0.1);
+  TEST_R(ts.size() == 23);
+
+  baseTS.realRandomWalk(ts, 0, 1.0, 20.0, 0.1);
+  TEST_R(ts.size() == 0);
+
+  //bounded normal random walk
+  baseTS.normalRandomWalk(ts, 100, 1.0, 20.0, 0.0);
+  TEST_R(ts.size() == 100);
+
+  baseTS.normalRandomWalk(ts, 23, 1.0, 20.0, 0.1);
+  TEST_R(ts.size() == 23);
+
+  baseTS.normalRandomWalk(ts, 0, 1.0, 20.0, 0.1);
+  TEST_R(ts.size() == 0);
+
+  //bounded linear random walk
+  baseTS.linearRandomWalk(ts, 100, 1.0, 3.0, 20.0, 0.0);
+  TEST_R(ts.size() == 100);
+
+  baseTS.linearRandomWalk(ts, 23, 1.0, 3.0, 20.0, 0.1);
+  TEST_R(ts.size() == 23);
+
+  baseTS.linearRandomWalk(ts, 0, 1.0, 3.0, 20.0, 0.1);
+  TEST_R(ts.size() == 0);
+
+  //uniform random
+  baseTS.uniformRandom(ts, 100, 1.0, 0.0);
+  TEST_R(ts.size() == 100);
+
+  baseTS.uniformRandom(ts, 23, 1.0, 0.1);
+  TEST_R(ts.size() == 23);
+
+  baseTS.uniformRandom(ts, 0, 1.0, 0.1);
+  TEST_R(ts.size() == 0);
+
+  //normal random
+  baseTS.normalRandom(ts, 100, 1.0, 0.0);
+  TEST_R(ts.size() == 100);
+
+  baseTS.normalRandom(ts, 23, 1.0, 0.1);
+  TEST_R(ts.size() == 23);
+
+  baseTS.normalRandom(ts, 0, 1.0, 0.1);
+  TEST_R(ts.size() == 0);
+
+  //piecewise linear random
+  baseTS.piecewiseLinearRandom(ts, 100, 1.0, 0.0);
+  TEST_R(ts.size() == 100);
+
+  baseTS.piecewiseLinearRandom(ts, 23, 1.0, 0.1);
+  TEST_R(ts.size() == 23);
+
+  baseTS.piecewiseLinearRandom(ts, 0, 1.0, 0.1);
+  TEST_R(ts.size() == 0);
+
+  //spline repeated
+  baseTS.splineRepeated(ts, 1000, 20.0, 20.0, 10, 2.0);
+  TEST_R(ts.size() == 1000);
+
+  baseTS.splineRepeated(ts, 23, 20.0, 20.0, 10, 2.0);
+  TEST_R(ts.size() == 23);
+
+  baseTS.splineRepeated(ts, 0, 20.0, 20.0, 10, 2.0);
+  TEST_R(ts.size() == 0);
+
+}
+
+void test_tsm() {
+
+  TEST_GROUP_FUNCTION;
+
+  tsg::rseq sums;
+  tsg::rseq sumSquares;
+  TestTSGenerator generator(300, 20, 20.0, 0.0, 2, 3, 50.0);
+
+  generator.testCalcRunnings(testTimeSeries);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+
+  tsg::TSM tsm(testTimeSeries, sums, sumSquares);
+
+  //test the z-normalized PAA implementation
+  tsg::rseq paa;
+  tsg::rseq paaGT = { 0.2569, 0.1308, -0.5240, -0.3319, 0.0035, -0.2243 };
+
+  try {
+
+    tsm.zNormalPAA(paa, 56, 20, 6);
+
+    for (int i = 0; i < (int)paaGT.size(); i++)
+      TEST_R(paa[i] < paaGT[i] + 0.0001 && paa[i] > paaGT[i] - 0.0001);
+  }
+  catch (...) {
+
+    TEST_R(!"Shouldn't throw an error!");
+  }
+
+  //test the invNormalCDF implementation
+  tsg::rseq bGT = { -std::numeric_limits<double>::infinity(), -0.8416, -0.2533,
+    0.2533, 0.8416, std::numeric_limits<double>::infinity() };
+
+  double cdf = tsm.invNormalCDF(1.0 / 5.0, 0.000001);
+
+  TEST_R(cdf < bGT[1] && cdf > bGT[1] - 0.0001);
+
+  tsg::rseq b;
+
+  try {
+
+    tsm.invNormalCDF(5, b, 0.000001);
+
+    TEST_R(b[0] == bGT[0]);
+    TEST_R(b[5] == bGT[5]);
+
+    for (int i = 1; i < (int)bGT.size() - 1; i++)
+      TEST_R(b[i] < bGT[i] + 0.0001 && b[i] > bGT[i] - 0.0001);
+  }
+  catch (...) {
+
+    TEST_R(!"Shouldn't throw an error!");
+  }
+
+  //test the z-normalized SAX implemenation
+  tsg::word sax;
+
+  try {
+
+    tsm.zNormalSAX(sax, 148, 20, 6, bGT);
+    TEST_R("Shouldn't throw an error!");
+  }
+  catch (...) {
+
+    TEST_R(!"Shouldn't throw an error!");
+  }
+
+  //test the SAX minimum distance function
+  double dist = -1.0;
+
+  try {
+
+    dist = tsm.saxDist({ 1, 1, 1, 1, 1 }, { 3, 3, 3, 3, 3}, 20, b);
+    TEST_R(dist == sqrt(20.0 / 5.0 * 5.0 * (b[1] - b[2]) * (b[1] - b[2])));
+
+    dist = tsm.saxDist({ 1, 1, 1, 1, 1 }, { 2, 2, 2, 2, 2}, 20, b);
+    TEST_R(dist == 0.0);
+  }
+  catch (...) {
+
+    TEST_R(!"Shouldn't throw an error!");
+  }
+
+  //test the z-normalized Euclidean distance function
+  dist = tsm.dist(topMotifSetPos[0], topMotifSetPos[1], 20.0);
+  TEST_R(abs(dist - testSequencesSimilarty) <= 0.0000001);
+
+  dist = tsm.dist(topMotifSetPos[1], topMotifSetPos[2], 20.0);
+  TEST_R(abs(dist) <= 0.0000001);
+
+  //test the ADM implementation
+  tsg::rseqs dGT = {
+    { 0, 7.43966, 6.2613, 6.24954, 6.50969, 5.62853 },
+    { 7.43966, 0, 4.00941, 5.40625, 4.59849, 7.11225 },
+    { 6.2613, 4.00941, 0, 4.70289, 2.52727, 5.94591 },
+    { 6.24954, 5.40625, 4.70289, 0, 4.4723, 6.72786 },
+    { 6.50969, 4.59849, 2.52727, 4.4723, 0, 5.5463 },
+    { 5.62853, 7.11225, 5.94591, 6.72786, 5.5463, 0 }
+  };
+
+  try {
+
+    tsm.adm({4, 32, 86, 111, 140, 268 }, 20.0, 7.0);
+    for (int i = 0; i < (int)dGT.size(); i++)
+      for (int j = 0; j < (int)dGT.size(); j++)
+        TEST_R(tsm.distADM(i, j) < dGT[i][j] + 0.0001 && tsm.distADM(i, j)
+            > dGT[i][j] - 0.0001);
+  }
+  catch (...) {
+
+    TEST_R(!"Shouldn't throw an error!");
+  }
+
+  //test the top set motif discovery implementation
+  tsg::iseq motif;
+
+  try {
+
+    TEST_R(tsm.tsm(motif, 20, 0.5) == 3);
+    TEST_R((int)motif.size() == 3);
+    TEST_R(tsm.tsm(motif, 20, 0.001) == 2);
+    TEST_R((int)motif.size() == 2);
+    TEST_R(tsm.tsm(motif, 20, 6.0) == 13);
+    TEST_R((int)motif.size() == 13);
+    for (int i = 0; i < (int)motif.size(); i++)
+      for (int j = 0; j < (int)motif.size(); j++)
+        if (i != j)
+          TEST_R(abs(motif[i] - motif[j]) >= 20);
+  }
+  catch (...) {
+
+    TEST_R(!"Shouldn't throw an error!");
+  }
+}
+
+void test_tpm() {
+
+  TEST_GROUP_FUNCTION;
+
+  tsg::rseq sums;
+  tsg::rseq sumSquares;
+  TestTSGenerator generator(300, 20, 20.0, 0.0, 2, 3, 50.0);
+
+  generator.testCalcRunnings(testTimeSeries);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+
+  //test the top pair motif discovery
+  int pos0 = -1;
+  int pos1 = -1;
+  double d = tsg::tpm(testTimeSeries, sums, sumSquares, pos0, pos1, 20);
+
+  TEST_R(pos0 == topMotifPairPos[0]);
+  TEST_R(pos1 == topMotifPairPos[1]);
+  TEST_R(abs(d - topMotifPairSimilarity) <= 0.0001);
+
+  //test the parallel top pair motif discovery
+  int ppos0 = -1;
+  int ppos1 = -1;
+  double pd;
+
+  for (int threads = 0; threads < 5; threads++) {
+
+    pd = tsg::tpm(testTimeSeries, sums, sumSquares, ppos0, ppos1, 20, threads);
+
+    TEST_R(pd == d);
+    TEST_R(ppos0 == pos0);
+    TEST_R(ppos1 == pos1);
+  }
+
+  //test the parallel version against the serial version on random walks
+  tsg::BaseTS baseTS;
+  tsg::rseq ts;
+  generator.setLength(2000);
+
+  for (int itr = 0; itr < 3; itr++) {
+
+    baseTS.realRandomWalk(ts, 2000, 1.0, 0.5);
+    generator.testCalcRunnings(ts);
+    sums = generator.getSums();
+    sumSquares = generator.getSumSquares();
+
+    d = tsg::tpm(ts, sums, sumSquares, pos0, pos1, 20);
+    pd = tsg::tpm(ts, sums, sumSquares, ppos0, ppos1, 20, 7);
+
+    TEST_R(pd == d);
+    TEST_R(ppos0 == pos0);
+    TEST_R(ppos1 == pos1);
+
+    //compare with the z-normalized Euclidean distance of the pair
+    TEST_R(abs(d - generator.testSimilarity(ts, pos0, pos1,
+            std::numeric_limits<double>::max())) <= 0.000001);
+  }
+
+  //test the minimum and maximum distance procedure
+  double min;
+  double max;
+  double dist;
+  double maxDist = 0.0;
+
+  generator.setLength(300);
+  generator.testCalcRunnings(testTimeSeries);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+
+  tsg::tpmMinMax(testTimeSeries, sums, sumSquares, 20, min, max);
+  d = tsg::tpm(testTimeSeries, sums, sumSquares, pos0, pos1, 20);
+
+  for (int i = 0; i < 281; i += 7)
+    for (int j = i + 20; j < 281; j += 5) {
+
+      dist = generator.testSimilarity(testTimeSeries, i, j,
+          std::numeric_limits<double>::max());
+
+      if (dist * dist > maxDist)
+        maxDist = dist * dist;
+    }
+
+  TEST_R(abs(min - d * d) <= 0.000001);
+  TEST_R(maxDist <= max + 0.000001);
+
+  //test the top k pair motifs procedure
+  tsg::iseq pos0s;
+  tsg::iseq pos1s;
+  tsg::rseq ds;
+
+  tsg::tpmTopK(testTimeSeries, sums, sumSquares, 20, 1, pos0s, pos1s, ds);
+
+  TEST_R(ds.size() == 1);
+  TEST_R(pos0s[0] == pos0);
+  TEST_R(pos1s[0] == pos1);
+  TEST_R(abs(ds[0] - d) <= 0.000001);
+
+  baseTS.realRandomWalk(ts, 2000, 1.0, 0.5);
+  generator.setLength(2000);
+  generator.testCalcRunnings(ts);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+
+  d = tsg::tpm(ts, sums, sumSquares, pos0, pos1, 20);
+  tsg::tpmTopK(ts, sums, sumSquares, 20, 5, pos0s, pos1s, ds);
+
+  TEST_R(ds.size() == 5);
+  TEST_R(pos0s[0] == pos0);
+  TEST_R(pos1s[0] == pos1);
+  TEST_R(abs(ds[0] - d) <= 0.000001);
+
+  bool sorted = true;
+  bool overlap = false;
+  bool correct = true;
+
+  for (int i = 0; i < 5; i++) {
+
+    if (i > 0 && ds[i] < ds[i - 1])
+      sorted = false;
+
+    for (int j = 0; j < i; j++)
+      if (abs(pos0s[i] - pos0s[j]) < 20 && abs(pos1s[i] - pos1s[j]) < 20)
+        overlap = true;
+
+    if (abs(ds[i] - generator.testSimilarity(ts, pos0s[i], pos1s[i],
+            std::numeric_limits<double>::max())) > 0.000001)
+      correct = false;
+  }
+
+  TEST_R(sorted);
+  TEST_R(!overlap);
+  TEST_R(correct);
+
+  //the pairs are the ones of a scan of all pairs sorted by distance, the
+  //scaled time series keeps the variance of all windows above 1
+  tsg::rseq scaled(ts);
+
+  for (auto &item : scaled)
+    item *= 100.0;
+
+  generator.testCalcRunnings(scaled);
+
+  tsg::rseq scaledSums = generator.getSums();
+  tsg::rseq scaledSumSquares = generator.getSumSquares();
+
+  tsg::tpmTopK(scaled, scaledSums, scaledSumSquares, 20, 5, pos0s, pos1s,
+      ds);
+
+  std::vector<std::pair<double, int>> allPairs;
+
+  for (int i = 0; i + 20 <= 2000; i++)
+    for (int j = i + 19; j + 20 <= 2000; j++)
+      allPairs.push_back({generator.testSimilarity(scaled, i, j,
+            std::numeric_limits<double>::max()), i * 2000 + j});
+
+  std::sort(allPairs.begin(), allPairs.end());
+
+  tsg::iseq bpos0s;
+  tsg::iseq bpos1s;
+  tsg::rseq bds;
+
+  for (auto &pair : allPairs) {
+
+    int i = pair.second / 2000;
+    int j = pair.second % 2000;
+    bool free = true;
+
+    for (int p = 0; p < (int)bds.size(); p++)
+      if (abs(bpos0s[p] - i) < 20 && abs(bpos1s[p] - j) < 20)
+        free = false;
+
+    if (free && bds.size() < 5) {
+
+      bpos0s.push_back(i);
+      bpos1s.push_back(j);
+      bds.push_back(pair.first);
+    }
+  }
+
+  correct = true;
+
+  for (int i = 0; i < 5; i++)
+    if (pos0s[i] != bpos0s[i] || pos1s[i] != bpos1s[i] || abs(ds[i] - bds[i])
+        > 0.000001)
+      correct = false;
+
+  TEST_R(correct);
+
+  //the parallel version returns the same pairs
+  tsg::iseq ppos0s;
+  tsg::iseq ppos1s;
+  tsg::rseq pds;
+
+  for (int threads : {2, 3, 7, 0}) {
+
+    tsg::tpmTopK(scaled, scaledSums, scaledSumSquares, 20, 5, ppos0s,
+        ppos1s, pds, threads);
+
+    TEST_R(ppos0s == pos0s);
+    TEST_R(ppos1s == pos1s);
+    TEST_R(pds == ds);
+  }
+
+  generator.testCalcRunnings(ts);
+
+  //test the anytime procedure
+  std::mt19937 randomEngine(42);
+  double fraction;
+
+  pd = tsg::tpmAnytime(ts, sums, sumSquares, ppos0, ppos1, 20, 0.0, 0,
+      randomEngine, fraction);
+
+  TEST_R(fraction == 1.0);
+  TEST_R(pd == d);
+
+  pd = tsg::tpmAnytime(ts, sums, sumSquares, ppos0, ppos1, 20, 0.0, 100,
+      randomEngine, fraction);
+
+  TEST_R(abs(fraction - 100.0 / 1962.0) <= 0.000001);
+  TEST_R(pd >= d);
+  TEST_R(abs(ppos1 - ppos0) >= 19);
+  TEST_R(abs(pd - generator.testSimilarity(ts, ppos0, ppos1,
+          std::numeric_limits<double>::max())) <= 0.000001);
+
+  pd = tsg::tpmAnytime(ts, sums, sumSquares, ppos0, ppos1, 20, 0.000001, 0,
+      randomEngine, fraction);
+
+  TEST_R(fraction > 0.0 && fraction <= 1.0);
+  TEST_R(pd >= d);
+
+  //the same seed visits the same diagonals
+  std::mt19937 engine0(7);
+  std::mt19937 engine1(7);
+  double d0 = tsg::tpmAnytime(ts, sums, sumSquares, pos0, pos1, 20, 0.0, 50,
+      engine0, fraction);
+  double d1 = tsg::tpmAnytime(ts, sums, sumSquares, ppos0, ppos1, 20, 0.0, 50,
+      engine1, fraction);
+
+  TEST_R(d0 == d1);
+  TEST_R(pos0 == ppos0);
+  TEST_R(pos1 == ppos1);
+
+  //the diagonal budget does not depend on the number of threads
+  for (int threads : {3, 0}) {
+
+    std::mt19937 engine(7);
+
+    d1 = tsg::tpmAnytime(ts, sums, sumSquares, ppos0, ppos1, 20, 0.0, 50,
+        engine, pd, threads);
+
+    TEST_R(d0 == d1);
+    TEST_R(pos0 == ppos0);
+    TEST_R(pos1 == ppos1);
+    TEST_R(pd == fraction);
+
+    engine.seed(7);
+    d1 = tsg::tpmAnytime(ts, sums, sumSquares, ppos0, ppos1, 20, 0.0, 0,
+        engine, pd, threads);
+
+    TEST_R(d1 == d);
+    TEST_R(pd == 1.0);
+  }
+
+  //test the histogram and threshold count procedures against brute force
+  generator.setLength(300);
+  generator.testCalcRunnings(testTimeSeries);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+
+  tsg::lseq counts;
+  tsg::lseq parallelCounts;
+  tsg::lseq bruteCounts(10, 0);
+  long long pairs = 0;
+  long long below = 0;
+  double threshold = 4.0;
+
+  tsg::tpmHistogram(testTimeSeries, sums, sumSquares, 20, 0.0, 10.0, 10,
+      counts);
+  tsg::tpmHistogram(testTimeSeries, sums, sumSquares, 20, 0.0, 10.0, 10,
+      parallelCounts, 3);
+
+  for (int i = 0; i < 281; i++)
+    for (int j = i + 19; j < 281; j++) {
+
+      dist = generator.testSimilarity(testTimeSeries, i, j,
+          std::numeric_limits<double>::max());
+
+      bruteCounts[std::min(std::max((int)dist, 0), 9)]++;
+      pairs++;
+
+      if (dist < threshold)
+        below++;
+    }
+
+  long long total = 0;
+
+  for (auto &item : counts)
+    total += item;
+
+  TEST_R(total == pairs);
+  TEST_R(counts == parallelCounts);
+  TEST_R(counts == bruteCounts);
+  TEST_R(tsg::tpmCount(testTimeSeries, sums, sumSquares, 20, threshold)
+      == below);
+  TEST_R(tsg::tpmCount(testTimeSeries, sums, sumSquares, 20, threshold, 4)
+      == below);
+  TEST_R(tsg::tpmCount(testTimeSeries, sums, sumSquares, 20, 0.0) == 0);
+
+  double pmin;
+  double pmax;
+
+  tsg::tpmMinMax(testTimeSeries, sums, sumSquares, 20, min, max);
+  tsg::tpmMinMax(testTimeSeries, sums, sumSquares, 20, pmin, pmax, 3);
+
+  TEST_R(pmin == min);
+  TEST_R(pmax == max);
+
+  //test the single precision procedures
+  d = tsg::tpm(testTimeSeries, sums, sumSquares, pos0, pos1, 20);
+  pd = tsg::tpmFloat(testTimeSeries, sums, sumSquares, ppos0, ppos1, 20);
+
+  TEST_R(ppos0 == pos0);
+  TEST_R(ppos1 == pos1);
+  TEST_R(abs(pd - d) <= 0.000001);
+
+  generator.setLength(2000);
+
+  for (int itr = 0; itr < 3; itr++) {
+
+    baseTS.realRandomWalk(ts, 2000, 1.0, 0.5);
+    generator.testCalcRunnings(ts);
+    sums = generator.getSums();
+    sumSquares = generator.getSumSquares();
+
+    d = tsg::tpm(ts, sums, sumSquares, pos0, pos1, 20);
+    pd = tsg::tpmFloat(ts, sums, sumSquares, ppos0, ppos1, 20);
+
+    TEST_R(pd >= d - 0.000001);
+    TEST_R(pd <= d + 0.01);
+    TEST_R(tsg::tpmFloat(ts, sums, sumSquares, pos0, pos1, 20, 3) == pd);
+    TEST_R(pos0 == ppos0);
+    TEST_R(pos1 == ppos1);
+  }
+
+  tsg::fseq tsFloat(ts.begin(), ts.end());
+  tsg::fseq sumsFloat;
+  tsg::fseq sumSquaresFloat;
+
+  tsg::runningsFloat(tsFloat, 20, sumsFloat, sumSquaresFloat);
+
+  TEST_R(sumsFloat.size() == sums.size());
+
+  bool close = true;
+
+  for (int i = 0; i < (int)sums.size(); i++)
+    if (abs(sumsFloat[i] - sums[i]) > 0.001 * (1.0 + abs(sums[i]))
+        || abs(sumSquaresFloat[i] - sumSquares[i]) > 0.001 * (1.0
+          + sumSquares[i]))
+      close = false;
+
+  TEST_R(close);
+
+  for (int i = 0; i < 1981; i += 97) {
+
+    d = generator.testSimilarity(ts, i, 1980 - i,
+        std::numeric_limits<double>::max());
+
+    TEST_R(abs(tsg::similarityFloat(tsFloat, sumsFloat, sumSquaresFloat, 20,
+            i, 1980 - i) - d) <= 0.01 * (1.0 + d));
+  }
+}
+
+void test_matrixprofile() {
+
+  TEST_GROUP_FUNCTION;
+
+  tsg::rseq sums;
+  tsg::rseq sumSquares;
+  TestTSGenerator generator(2000, 20, 20.0, 0.0, 2, 3, 50.0);
+  tsg::BaseTS baseTS;
+  tsg::rseq ts;
+  int pos0 = -1;
+  int pos1 = -1;
+  int mpPos0 = -1;
+  int mpPos1 = -1;
+  double d;
+  double mpD;
+
+  baseTS.realRandomWalk(ts, 2000, 1.0, 0.5);
+  generator.testCalcRunnings(ts);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+
+  //test the top pair motif of the matrix profile
+  tsg::MatrixProfile matrixProfile(20, 19);
+
+  d = tsg::tpm(ts, sums, sumSquares, pos0, pos1, 20);
+  mpD = matrixProfile.topPair(ts, sums, sumSquares, mpPos0, mpPos1, 3);
+
+  TEST_R(abs(d - mpD) <= 0.000001);
+  TEST_R(mpPos0 == pos0);
+  TEST_R(mpPos1 == pos1);
+  TEST_R(matrixProfile.neighbor(pos0) == pos1);
+  TEST_R(matrixProfile.neighbor(pos1) == pos0);
+
+  //test the incremental refresh after edits of the time series
+  tsg::rseq backup;
+
+  for (int itr = 0; itr < 5; itr++) {
+
+    int pos = 37 + itr * 389;
+
+    backup.assign(ts.begin() + pos, ts.begin() + pos + 20);
+
+    for (int i = pos; i < pos + 20; i++)
+      ts[i] = ts[pos] + 5.0 * sin(0.3 * (itr + 1) * (i - pos));
+
+    generator.testUpdateRunnings(ts, pos);
+    sums = generator.getSums();
+    sumSquares = generator.getSumSquares();
+    matrixProfile.invalidate(pos);
+
+    if (itr % 2) {
+
+      for (int i = pos; i < pos + 20; i++)
+        ts[i] = backup[i - pos];
+
+      generator.testUpdateRunnings(ts, pos);
+      sums = generator.getSums();
+      sumSquares = generator.getSumSquares();
+      matrixProfile.invalidate(pos);
+    }
+
+    matrixProfile.refresh(ts, sums, sumSquares);
+
+    tsg::MatrixProfile fresh(20, 19);
+    fresh.refresh(ts, sums, sumSquares);
+
+    bool equal = true;
+
+    for (int i = 0; i < (int)sums.size(); i++)
+      if (abs(matrixProfile.distance(i) - fresh.distance(i)) > 0.000001)
+        equal = false;
+
+    TEST_R(equal);
+
+    d = tsg::tpm(ts, sums, sumSquares, pos0, pos1, 20);
+    mpD = matrixProfile.topPair(ts, sums, sumSquares, mpPos0, mpPos1);
+
+    TEST_R(abs(d - mpD) <= 0.000001);
+    TEST_R(mpPos0 == pos0);
+    TEST_R(mpPos1 == pos1);
+  }
+
+  //test the public matrix profile procedure
+  tsg::rseq profile;
+  tsg::iseq index;
+  tsg::rseq parallelProfile;
+  tsg::iseq parallelIndex;
+
+  tsg::matrixProfile(ts, sums, sumSquares, 20, 19, profile, index);
+  tsg::matrixProfile(ts, sums, sumSquares, 20, 19, parallelProfile,
+      parallelIndex, 4);
+
+  TEST_R(profile.size() == sums.size());
+  TEST_R(index.size() == sums.size());
+  TEST_R(profile == parallelProfile);
+  TEST_R(index == parallelIndex);
+
+  //test the squared matrix profile procedure
+  tsg::rseq squaredProfile;
+  tsg::iseq squaredIndex;
+
+  tsg::squaredMatrixProfile(ts, tsg::SubsequenceStats(20, sums, sumSquares),
+      19, squaredProfile, squaredIndex, 2);
+
+  bool squared = squaredIndex == index;
+
+  for (int i = 0; i < (int)sums.size(); i++)
+    if (squaredProfile[i] < 0.0 || abs(sqrt(squaredProfile[i]) - profile[i])
+        > 0.000001)
+      squared = false;
+
+  TEST_R(squared);
+
+  bool equal = true;
+
+  for (int i = 0; i < (int)sums.size(); i++)
+    if (abs(profile[i] - matrixProfile.distance(i)) > 0.000001)
+      equal = false;
+
+  TEST_R(equal);
+
+  //test a custom exclusion zone against brute force, the time series is
+  //scaled such that no standard deviation is clamped
+  tsg::rseq shortTs(ts.begin(), ts.begin() + 300);
+
+  for (auto &item : shortTs)
+    item *= 10.0;
+
+  generator.setLength(300);
+  generator.testCalcRunnings(shortTs);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+  tsg::matrixProfile(shortTs, sums, sumSquares, 20, 5, profile, index, 2);
+
+  bool exclusion = true;
+
+  equal = true;
+
+  for (int i = 0; i < (int)sums.size(); i++) {
+
+    double best = std::numeric_limits<double>::infinity();
+
+    for (int j = 0; j < (int)sums.size(); j++)
+      if (abs(i - j) >= 5)
+        best = std::min(best, generator.testSimilarity(shortTs, i, j,
+              std::numeric_limits<double>::max()));
+
+    if (abs(profile[i] - best) > 0.000001)
+      equal = false;
+
+    if (abs(i - index[i]) < 5)
+      exclusion = false;
+  }
+
+  TEST_R(equal);
+  TEST_R(exclusion);
+
+  //test the tiles of the matrix profile procedure on a long time series, the
+  //values are bounded such that the iterative dot products do not drift and
+  //scaled such that no standard deviation is clamped
+  tsg::rseq longTs(9000);
+
+  for (int i = 0; i < 9000; i++)
+    longTs[i] = 10.0 * sin(i * 0.01) + (i * 7919) % 13;
+  generator.setLength(9000);
+  generator.testCalcRunnings(longTs);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+  tsg::matrixProfile(longTs, sums, sumSquares, 20, 19, profile, index);
+  tsg::matrixProfile(longTs, sums, sumSquares, 20, 19, parallelProfile,
+      parallelIndex, 3);
+
+  TEST_R(profile == parallelProfile);
+  TEST_R(index == parallelIndex);
+
+  d = tsg::tpm(longTs, sums, sumSquares, pos0, pos1, 20);
+
+  TEST_R(abs(*std::min_element(profile.begin(), profile.end()) - d)
+      <= 0.000001);
+
+  equal = true;
+
+  for (int i : {0, 4500, 8980}) {
+
+    double best = std::numeric_limits<double>::infinity();
+
+    for (int j = 0; j < (int)sums.size(); j++)
+      if (abs(i - j) >= 19)
+        best = std::min(best, generator.testSimilarity(longTs, i, j,
+              std::numeric_limits<double>::max()));
+
+    if (abs(profile[i] - best) > 0.000001)
+      equal = false;
+  }
+
+  TEST_R(equal);
+}
+
+void test_runningstats() {
+
+  TEST_GROUP_FUNCTION;
+
+  int window = 50;
+  tsg::rseq ts(20000);
+  tsg::rseq sums(ts.size() - window + 1);
+  tsg::rseq sumSquares(ts.size() - window + 1);
+  tsg::rseq naiveSums, naiveSumSquares;
+  std::mt19937 engine(3);
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  //random walk with a large offset
+  ts[0] = 1e7;
+
+  for (int i = 1; i < (int)ts.size(); i++)
+    ts[i] = ts[i - 1] + normal(engine);
+
+  tsg::RunningStats runnings(window);
+
+  runnings.compute(ts);
+  TEST_R(runnings.getWindow() == window);
+  TEST_R(runnings.size() == (int)sums.size());
+
+  //test the means and variances against a two-pass computation
+  auto accurate = [&](const tsg::RunningStats &runnings_in) {
+
+    bool flag = true;
+
+    for (int i = 0; i < runnings_in.size(); i += 37) {
+
+      long double mean = 0.0, var = 0.0;
+
+      for (int j = 0; j < window; j++)
+        mean += ts[i + j];
+
+      mean /= window;
+
+      for (int j = 0; j < window; j++)
+        var += (ts[i + j] - mean) * (ts[i + j] - mean);
+
+      var /= window;
+
+      if (std::abs(runnings_in.getMean(i) - mean) > 1e-9
+          || std::abs(runnings_in.getVariance(i) - var) > 1e-9 * var)
+        flag = false;
+    }
+
+    return flag;
+  };
+
+  TEST_R(accurate(runnings));
+
+  //the unshifted running sums equal the ones of the utilities
+  bool equal = true;
+
+  runnings.getRunnings(0, runnings.size(), sums, sumSquares);
+  tsg::calcRunnings(ts, window, naiveSums, naiveSumSquares);
+
+  for (int i = 0; i < runnings.size(); i++)
+    if (std::abs(sums[i] - naiveSums[i]) > 1e-6 * std::abs(sums[i])
+        || std::abs(sumSquares[i] - naiveSumSquares[i]) > 1e-6
+        * sumSquares[i])
+      equal = false;
+
+  TEST_R(equal);
+
+  //test the incremental update after many edits
+  for (int itr = 0; itr < 200; itr++) {
+
+    int pos = (int)(engine() % (ts.size() - window + 1));
+
+    for (int i = 0; i < window; i++)
+      ts[pos + i] += normal(engine);
+
+    runnings.update(ts, pos);
+  }
+
+  TEST_R(accurate(runnings));
+
+  //test the copy of the runnings around a position
+  tsg::RunningStats copy(window);
+
+  copy.compute(ts);
+
+  for (int i = 0; i < window; i++)
+    ts[1000 + i] += 5.0;
+
+  runnings.update(ts, 1000);
+  copy.update(runnings, 1000);
+
+  equal = true;
+
+  for (int i = 0; i < runnings.size(); i++)
+    if (i >= 1000 - window + 1 && i < 1000 + window
+        && copy.getVariance(i) != runnings.getVariance(i))
+      equal = false;
+
+  TEST_R(equal);
+  TEST_R(accurate(copy));
+}
+
+void test_prefixstats() {
+
+  TEST_GROUP_FUNCTION;
+
+  tsg::rseq ts(20000);
+  std::mt19937 engine(5);
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  //random walk with a large offset
+  ts[0] = 1e7;
+
+  for (int i = 1; i < (int)ts.size(); i++)
+    ts[i] = ts[i - 1] + normal(engine);
+
+  tsg::PrefixStats prefix(ts);
+
+  TEST_R(prefix.size() == (int)ts.size());
+
+  //test any position and length against a two-pass computation
+  bool accurate = true;
+
+  for (int length : { 1, 7, 30, 100, 1000 })
+    for (int i = 0; i + length <= (int)ts.size(); i += 101) {
+
+      long double mean = 0.0, var = 0.0;
+
+      for (int j = 0; j < length; j++)
+        mean += ts[i + j];
+
+      mean /= length;
+
+      for (int j = 0; j < length; j++)
+        var += (ts[i + j] - mean) * (ts[i + j] - mean);
+
+      var /= length;
+
+      if (std::abs(prefix.getMean(i, length) - mean) > 1e-15 * mean
+          || std::abs(prefix.getVariance(i, length) - var) > 1e-12 * var
+          + 1e-12
+          || std::abs(prefix.getStdDev(i, length) - sqrt((double)var))
+          > 1e-9 * sqrt((double)var) + 1e-6)
+        accurate = false;
+    }
+
+  TEST_R(accurate);
+
+  //the statistics of several window sizes from one pass
+  for (int window : { 30, 100 }) {
+
+    tsg::RunningStats runnings(window);
+    tsg::SubsequenceStats stats(window);
+    tsg::SubsequenceStats fromPrefix(window);
+    bool equal = true;
+
+    runnings.compute(ts);
+    stats.compute(runnings);
+    fromPrefix.compute(prefix);
+
+    TEST_R(fromPrefix.size() == stats.size());
+
+    for (int i = 0; i < stats.size(); i++)
+      if (std::abs(fromPrefix.getMean()[i] - stats.getMean()[i]) > 1e-15
+          * std::abs(stats.getMean()[i])
+          || std::abs(fromPrefix.getRSigma()[i] / stats.getRSigma()[i]
+            - 1.0) > 1e-9)
+        equal = false;
+
+    TEST_R(equal);
+  }
+
+  //an empty time series has no statistics
+  prefix.compute(tsg::rseq());
+  TEST_R(prefix.size() == 0);
+}
+
+void test_subsequencestats() {
+
+  TEST_GROUP_FUNCTION;
+
+  tsg::rseq sums;
+  tsg::rseq sumSquares;
+  TestTSGenerator generator(1000, 20, 20.0, 0.0, 2, 3, 50.0);
+  tsg::BaseTS baseTS;
+  tsg::rseq ts;
+  int pos0 = -1;
+  int pos1 = -1;
+  int statsPos0 = -1;
+  int statsPos1 = -1;
+
+  baseTS.realRandomWalk(ts, 1000, 1.0, 0.5);
+  generator.testCalcRunnings(ts);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+
+  //test the statistics against the running sums
+  tsg::SubsequenceStats stats(20, sums, sumSquares);
+
+  TEST_R(stats.getWindow() == 20);
+  TEST_R(stats.size() == (int)sums.size());
+
+  bool equal = true;
+
+  for (int i = 0; i < stats.size(); i++) {
+
+    double mean = sums[i] / 20.0;
+    double var = sumSquares[i] / 20.0 - mean * mean;
+    double sigma = var < 1.0 ? 1.0 : sqrt(var);
+
+    if (abs(stats.getMean()[i] - mean) > 0.000001
+        || abs(stats.getRSigma()[i] * sigma - 1.0) > 0.000001)
+      equal = false;
+  }
+
+  TEST_R(equal);
+
+  //test the incremental update after an edit of the time series
+  for (int i = 0; i < 20; i++)
+    ts[500 + i] += 10.0 * i;
+
+  generator.testUpdateRunnings(ts, 500);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+  stats.update(sums, sumSquares, 500);
+
+  tsg::SubsequenceStats fresh(20, sums, sumSquares);
+
+  TEST_R(stats.getMean() == fresh.getMean());
+  TEST_R(stats.getRSigma() == fresh.getRSigma());
+
+  //test the kernels with precomputed statistics
+  double d = tsg::tpm(ts, sums, sumSquares, pos0, pos1, 20);
+
+  TEST_R(tsg::tpm(ts, stats, statsPos0, statsPos1, 2) == d);
+  TEST_R(statsPos0 == pos0);
+  TEST_R(statsPos1 == pos1);
+
+  generator.setLength(1000);
+  d = generator.testSimilarity(ts, pos0, pos1,
+      std::numeric_limits<double>::max());
+
+  TEST_R(abs(tsg::zNormEuclDist(ts, pos0, pos1, stats,
+          std::numeric_limits<double>::max()) - d) <= 0.000001);
+  TEST_R(abs(tsg::zNormEuclDist(ts, pos0, pos1, 20, sums, sumSquares,
+          std::numeric_limits<double>::max()) - d) <= 0.000001);
+
+  TestTSM tsm(ts, sums, sumSquares);
+
+  TEST_R(abs(tsm.dist(pos0, pos1, 20) - d) <= 0.000001);
+
+  //test the lower bound of the segment means against the similarity
+  bool bounded = true;
+
+  TEST_R(fresh.lowerBound(0, 500, 0.0) == 0.0);
+
+  fresh.computeSegments(ts, 4);
+
+  for (int i = 0; i < 980; i += 7)
+    for (int j = 0; j < 980; j += 13)
+      if (fresh.lowerBound(i, j, std::numeric_limits<double>::max())
+          > tsg::zNormEuclDist(ts, i, j, fresh,
+            std::numeric_limits<double>::max()))
+        bounded = false;
+
+  TEST_R(bounded);
+
+  //test the incremental update of the segment means
+  for (int i = 0; i < 10; i++)
+    ts[300 + i] -= 5.0 * i;
+
+  generator.testUpdateRunnings(ts, 300);
+  fresh.update(generator.getSums(), generator.getSumSquares(), 300);
+  fresh.updateSegments(ts, 300);
+
+  tsg::SubsequenceStats segments(20, generator.getSums(),
+      generator.getSumSquares());
+
+  segments.computeSegments(ts, 4);
+
+  for (int i = 0; i < 980; i += 11)
+    TEST_R(fresh.lowerBound(290, i, std::numeric_limits<double>::max())
+        == segments.lowerBound(290, i, std::numeric_limits<double>::max()));
+
+  //test the segment means of the prefix sums against the direct sums of the
+  //updates
+  tsg::RunningStats longRunnings(200);
+  tsg::SubsequenceStats prefixSegments(200);
+
+  longRunnings.compute(ts);
+  prefixSegments.compute(longRunnings);
+  prefixSegments.computeSegments(ts, tsg::prefixSegment);
+
+  tsg::SubsequenceStats directSegments(prefixSegments);
+
+  for (int pos = 0; pos < 1000; pos += 200)
+    directSegments.updateSegments(ts, pos);
+
+  bounded = true;
+
+  for (int i = 0; i < 801; i += 13)
+    if (abs(prefixSegments.lowerBound(400, i,
+            std::numeric_limits<double>::max()) - directSegments.lowerBound(
+            400, i, std::numeric_limits<double>::max())) > 0.000001)
+      bounded = false;
+
+  TEST_R(bounded);
+  TEST_R(prefixSegments.lowerBound(400, 0, std::numeric_limits<double>::max())
+      > 0.0);
+}
+
+void test_distanceprofile() {
+
+  TEST_GROUP_FUNCTION;
+
+  //redirect cerr
+  std::stringstream buffer;
+  std::streambuf *cerr_buff = std::cerr.rdbuf(buffer.rdbuf());
+
+  //test the fast Fourier transform against the discrete Fourier transform
+  const double pi = 3.14159265358979323846;
+  tsg::cseq data(64);
+  tsg::cseq spectrum;
+  tsg::cseq dft(64, 0.0);
+
+  for (int i = 0; i < 64; i++)
+    data[i] = std::complex<double>(sin(0.3 * i) + 0.01 * i, cos(0.7 * i));
+
+  for (int k = 0; k < 64; k++)
+    for (int i = 0; i < 64; i++)
+      dft[k] += data[i] * std::polar(1.0, -2.0 * pi * k * i / 64.0);
+
+  spectrum = data;
+  tsg::fft(spectrum);
+
+  bool equal = true;
+
+  for (int k = 0; k < 64; k++)
+    if (std::abs(spectrum[k] - dft[k]) > 0.000001)
+      equal = false;
+
+  TEST_R(equal);
+
+  tsg::fft(spectrum, true);
+  equal = true;
+
+  for (int i = 0; i < 64; i++)
+    if (std::abs(spectrum[i] - data[i]) > 0.000001)
+      equal = false;
+
+  TEST_R(equal);
+
+  data.resize(48);
+
+  try {
+
+    tsg::fft(data);
+    TEST_R(!"Has to throw an error!");
+  }
+  catch (int e) {
+
+    TEST_R(e == EXIT_FAILURE);
+  }
+
+  //test the distance profiles against the similarity
+  tsg::rseq sums;
+  tsg::rseq sumSquares;
+  TestTSGenerator generator(1500, 25, 20.0, 0.0, 2, 3, 50.0);
+  tsg::BaseTS baseTS;
+  tsg::rseq ts;
+
+  baseTS.realRandomWalk(ts, 1500, 1.0, 0.5);
+  generator.testCalcRunnings(ts);
+  generator.setLength(1500);
+  sums = generator.getSums();
+  sumSquares = generator.getSumSquares();
+
+  tsg::SubsequenceStats stats(25, sums, sumSquares);
+  tsg::DistanceProfile distanceProfile(ts, stats);
+  tsg::rseq profile0;
+  tsg::rseq profile1;
+  tsg::rseq profile;
+  double d;
+
+  distanceProfile.compute(17, 1200, profile0, profile1);
+
+  TEST_R((int)profile0.size() == (int)sums.size());
+  TEST_R(distanceProfile.getError() > 0.0);
+  TEST_R(distanceProfile.getError() < 0.0001);
+
+  equal = true;
+
+  for (int j = 0; j < (int)sums.size(); j++) {
+
+    d = generator.testSimilarity(ts, 17, j,
+        std::numeric_limits<double>::max());
+
+    if (abs(profile0[j] * profile0[j] - d * d) > distanceProfile.getError())
+      equal = false;
+
+    d = generator.testSimilarity(ts, 1200, j,
+        std::numeric_limits<double>::max());
+
+    if (abs(profile1[j] * profile1[j] - d * d) > distanceProfile.getError())
+      equal = false;
+  }
+
+  TEST_R(equal);
 
-  //bounded real random walk
-  baseTS.realRandomWalk(ts, 100, 1.0, 20.0, 0.0);
-  TEST_R(ts.size() == 100);
+  //test single and arbitrary queries against the paired profiles
+  distanceProfile.compute(1200, profile);
+  equal = true;
 
-  baseTS.realRandomWalk(ts, 23, 1.0, 20.0, 0.1);
-  TEST_R(ts.size() == 23);
+  for (int j = 0; j < (int)sums.size(); j++)
+    if (abs(profile[j] - profile1[j]) > 0.000001)
+      equal = false;
 
-  baseTS.realRandomWalk(ts, 0, 1.0, 20.0, 0.1);
-  TEST_R(ts.size() == 0);
+  TEST_R(equal);
 
-  //bounded normal random walk
-  baseTS.normalRandomWalk(ts, 100, 1.0, 20.0, 0.0);
-  TEST_R(ts.size() == 100);
+  tsg::rseq query(ts.begin() + 17, ts.begin() + 42);
 
-  baseTS.normalRandomWalk(ts, 23, 1.0, 20.0, 0.1);
-  TEST_R(ts.size() == 23);
+  distanceProfile.compute(query, profile);
+  equal = true;
 
-  baseTS.normalRandomWalk(ts, 0, 1.0, 20.0, 0.1);
-  TEST_R(ts.size() == 0);
+  for (int j = 0; j < (int)sums.size(); j++)
+    if (abs(profile[j] - profile0[j]) > 0.000001)
+      equal = false;
 
-  //bounded linear random walk
-  baseTS.linearRandomWalk(ts, 100, 1.0, 3.0, 20.0, 0.0);
-  TEST_R(ts.size() == 100);
+  TEST_R(equal);
 
-  baseTS.linearRandomWalk(ts, 23, 1.0, 3.0, 20.0, 0.1);
-  TEST_R(ts.size() == 23);
+  query.resize(20);
 
-  baseTS.linearRandomWalk(ts, 0, 1.0, 3.0, 20.0, 0.1);
-  TEST_R(ts.size() == 0);
+  try {
 
-  //uniform random
-  baseTS.uniformRandom(ts, 100, 1.0, 0.0);
-  TEST_R(ts.size() == 100);
+    distanceProfile.compute(query, profile);
+    TEST_R(!"Has to throw an error!");
+  }
+  catch (int e) {
 
-  baseTS.uniformRandom(ts, 23, 1.0, 0.1);
-  TEST_R(ts.size() == 23);
+    TEST_R(e == EXIT_FAILURE);
+  }
 
-  baseTS.uniformRandom(ts, 0, 1.0, 0.1);
-  TEST_R(ts.size() == 0);
+  try {
 
-  //normal random
-  baseTS.normalRandom(ts, 100, 1.0, 0.0);
-  TEST_R(ts.size() == 100);
+    distanceProfile.compute(1476, profile);
+    TEST_R(!"Has to throw an error!");
+  }
+  catch (int e) {
 
-  baseTS.normalRandom(ts, 23, 1.0, 0.1);
-  TEST_R(ts.size() == 23);
+    TEST_R(e == EXIT_FAILURE);
+  }
 
-  baseTS.normalRandom(ts, 0, 1.0, 0.1);
-  TEST_R(ts.size() == 0);
+  //test the sweeps against the similarity
+  equal = true;
 
-  //piecewise linear random
-  baseTS.piecewiseLinearRandom(ts, 100, 1.0, 0.0);
-  TEST_R(ts.size() == 100);
+  for (int i = 600; i < 660; i += i < 630 ? 1 : 7) {
 
-  baseTS.piecewiseLinearRandom(ts, 23, 1.0, 0.1);
-  TEST_R(ts.size() == 23);
+    distanceProfile.sweep(i, profile);
 
-  baseTS.piecewiseLinearRandom(ts, 0, 1.0, 0.1);
-  TEST_R(ts.size() == 0);
+    for (int j = 0; j < (int)sums.size(); j += 3) {
 
-  //spline repeated
-  baseTS.splineRepeated(ts, 1000, 20.0, 20.0, 10, 2.0);
-  TEST_R(ts.size() == 1000);
+      d = generator.testSimilarity(ts, i, j,
+          std::numeric_limits<double>::max());
 
-  baseTS.splineRepeated(ts, 23, 20.0, 20.0, 10, 2.0);
-  TEST_R(ts.size() == 23);
+      if (abs(profile[j] * profile[j] - d * d) > distanceProfile.getError())
+        equal = false;
+    }
+  }
 
-  baseTS.splineRepeated(ts, 0, 20.0, 20.0, 10, 2.0);
-  TEST_R(ts.size() == 0);
+  TEST_R(equal);
+  TEST_R(distanceProfile.getError() < 0.0001);
 
+  //test the cost models
+  TEST_R(!tsg::preferDistanceProfile(1500, 25, 1.0));
+  TEST_R(tsg::preferDistanceProfile(100000, 150, 10.0));
+  TEST_R(tsg::preferSweep(49, 25, 1.0));
+  TEST_R(!tsg::preferSweep(1, 25, 1.0));
+
+  //reset cerr
+  std::cerr.rdbuf(cerr_buff);
 }
 
-void test_tsm() {
+void test_distancekernel() {
 
   TEST_GROUP_FUNCTION;
 
-  tsg::rseq sums;
-  tsg::rseq sumSquares;
-  TestTSGenerator generator(300, 20, 20.0, 0.0, 2, 3, 50.0);
+  tsg::BaseTS baseTS;
+  tsg::rseq ts;
+  bool exact = true;
+  bool abandoned = true;
 
-  generator.testCalcRunnings(testTimeSeries);
-  sums = generator.getSums();
-  sumSquares = generator.getSumSquares();
+  baseTS.realRandomWalk(ts, 1000, 1.0, 0.5);
 
-  tsg::TSM tsm(testTimeSeries, sums, sumSquares);
+  //test the generic and specialized kernels against the scalar distance
+  for (int window : { 3, 8, 20, 30, 37, 40, 64, 100, 150 })
+    for (int i = 0; i + window <= 1000; i += 97)
+      for (int j = 0; j + window <= 1000; j += 89) {
 
-  //test the z-normalized PAA implementation
-  tsg::rseq paa;
-  tsg::rseq paaGT = { 0.2569, 0.1308, -0.5240, -0.3319, 0.0035, -0.2243 };
+        double mean0 = 0.0;
+        double mean1 = 0.0;
+        double var0 = 0.0;
+        double var1 = 0.0;
+        double dist = 0.0;
+        double diff;
 
-  try {
+        for (int k = 0; k < window; k++) {
 
-    tsm.zNormalPAA(paa, 56, 20, 6);
+          mean0 += ts[i + k];
+          mean1 += ts[j + k];
+          var0 += ts[i + k] * ts[i + k];
+          var1 += ts[j + k] * ts[j + k];
+        }
 
-    for (int i = 0; i < (int)paaGT.size(); i++)
-      TEST_R(paa[i] < paaGT[i] + 0.0001 && paa[i] > paaGT[i] - 0.0001);
-  }
-  catch (...) {
+        mean0 /= window;
+        mean1 /= window;
+        var0 = var0 / window - mean0 * mean0;
+        var1 = var1 / window - mean1 * mean1;
 
-    TEST_R(!"Shouldn't throw an error!");
-  }
+        double rSigma0 = var0 > 1.0 ? 1.0 / sqrt(var0) : 1.0;
+        double rSigma1 = var1 > 1.0 ? 1.0 / sqrt(var1) : 1.0;
 
-  //test the invNormalCDF implementation
-  tsg::rseq bGT = { -std::numeric_limits<double>::infinity(), -0.8416, -0.2533,
-    0.2533, 0.8416, std::numeric_limits<double>::infinity() };
+        for (int k = 0; k < window; k++) {
 
-  double cdf = tsm.invNormalCDF(1.0 / 5.0, 0.000001);
+          diff = (ts[i + k] - mean0) * rSigma0 - (ts[j + k] - mean1)
+            * rSigma1;
+          dist += diff * diff;
+        }
 
-  TEST_R(cdf < bGT[1] && cdf > bGT[1] - 0.0001);
+        dist = sqrt(dist);
 
-  tsg::rseq b;
+        if (abs(tsg::zNormDistance(ts.data() + i, ts.data() + j, window,
+                mean0, rSigma0, mean1, rSigma1) - dist) > 0.000001)
+          exact = false;
 
-  try {
+        //abandoned distances are not smaller than the best so far
+        double d = tsg::zNormDistance(ts.data() + i, ts.data() + j, window,
+            mean0, rSigma0, mean1, rSigma1, 0.5 * dist);
 
-    tsm.invNormalCDF(5, b, 0.000001);
+        if (d < 0.5 * dist || d > dist + 0.000001)
+          abandoned = false;
+      }
 
-    TEST_R(b[0] == bGT[0]);
-    TEST_R(b[5] == bGT[5]);
+  TEST_R(exact);
+  TEST_R(abandoned);
+  TEST_R(tsg::zNormDistance(ts.data(), ts.data(), 100, 0.0, 1.0, 0.0, 1.0,
+        0.0) == 0.0);
+}
 
-    for (int i = 1; i < (int)bGT.size() - 1; i++)
-      TEST_R(b[i] < bGT[i] + 0.0001 && b[i] > bGT[i] - 0.0001);
-  }
-  catch (...) {
+void test_distancerowcache() {
 
-    TEST_R(!"Shouldn't throw an error!");
-  }
+  TEST_GROUP_FUNCTION;
 
-  //test the z-normalized SAX implemenation
-  tsg::word sax;
+  //rows of 100 values, room for three rows
+  tsg::DistanceRowCache cache(10, 300 * sizeof(double));
+  std::shared_ptr<tsg::rseq> row;
 
-  try {
+  for (int i = 0; i < 4; i++)
+    cache.insert(20 * i, 1.5, std::make_shared<tsg::rseq>(100, i + 0.5));
 
-    tsm.zNormalSAX(sax, 148, 20, 6, bGT);
-    TEST_R("Shouldn't throw an error!");
-  }
-  catch (...) {
+  //the least recently used row is dropped
+  TEST_R(cache.find(0, 1.5) == nullptr);
+  TEST_R(cache.find(20, 1.5) != nullptr);
+  TEST_R(cache.find(40, 1.5) != nullptr);
+  TEST_R(cache.find(60, 1.5) != nullptr);
 
-    TEST_R(!"Shouldn't throw an error!");
-  }
+  //rows of other ranges are not found
+  TEST_R(cache.find(20, 2.0) == nullptr);
+  TEST_R(cache.getHits() == 3);
+  TEST_R(cache.getMisses() == 2);
 
-  //test the SAX minimum distance function
-  double dist = -1.0;
+  //the row of 20 is the least recently used row
+  cache.find(40, 1.5);
+  cache.find(60, 1.5);
+  cache.insert(80, 1.5, std::make_shared<tsg::rseq>(100, 0.25));
+  TEST_R(cache.find(20, 1.5) == nullptr);
 
-  try {
+  //an edit drops the overlapping rows and invalidates the entries of the
+  //overlapping subsequences in all other rows
+  cache.invalidate(45);
+  TEST_R(cache.find(40, 1.5) == nullptr);
 
-    dist = tsm.saxDist({ 1, 1, 1, 1, 1 }, { 3, 3, 3, 3, 3}, 20, b);
-    TEST_R(dist == sqrt(20.0 / 5.0 * 5.0 * (b[1] - b[2]) * (b[1] - b[2])));
+  row = cache.find(80, 1.5);
 
-    dist = tsm.saxDist({ 1, 1, 1, 1, 1 }, { 2, 2, 2, 2, 2}, 20, b);
-    TEST_R(dist == 0.0);
-  }
-  catch (...) {
+  if (TEST_IF(row != nullptr)) {
 
-    TEST_R(!"Shouldn't throw an error!");
+    bool flag = true;
+
+    for (int j = 0; j < 100; j++)
+      if (((*row)[j] < 0.0) != (j >= 36 && j < 55))
+        flag = false;
+
+    TEST_R(flag);
   }
 
-  //test the z-normalized Euclidean distance function
-  dist = tsm.dist(topMotifSetPos[0], topMotifSetPos[1], 20.0);
-  TEST_R(abs(dist - testSequencesSimilarty) <= 0.0000001);
+  //rows exceeding the capacity are not cached
+  cache.insert(0, 1.5, std::make_shared<tsg::rseq>(301, 0.5));
+  TEST_R(cache.find(0, 1.5) == nullptr);
 
-  dist = tsm.dist(topMotifSetPos[1], topMotifSetPos[2], 20.0);
-  TEST_R(abs(dist) <= 0.0000001);
+  //a capacity of 0 disables the cache
+  cache.setCapacity(0);
+  TEST_R(cache.find(80, 1.5) == nullptr);
+  cache.insert(80, 1.5, std::make_shared<tsg::rseq>(100, 0.25));
+  TEST_R(cache.find(80, 1.5) == nullptr);
 
-  //test the ADM implementation
-  tsg::rseqs dGT = {
-    { 0, 7.43966, 6.2613, 6.24954, 6.50969, 5.62853 },
-    { 7.43966, 0, 4.00941, 5.40625, 4.59849, 7.11225 },
-    { 6.2613, 4.00941, 0, 4.70289, 2.52727, 5.94591 },
-    { 6.24954, 5.40625, 4.70289, 0, 4.4723, 6.72786 },
-    { 6.50969, 4.59849, 2.52727, 4.4723, 0, 5.5463 },
-    { 5.62853, 7.11225, 5.94591, 6.72786, 5.5463, 0 }
-  };
+  cache.clear();
+  TEST_R(cache.getHits() == 0);
+  TEST_R(cache.getMisses() == 0);
+}
 
-  try {
+void test_threadpool() {
 
-    tsm.adm({4, 32, 86, 111, 140, 268 }, 20.0, 7.0);
-    for (int i = 0; i < (int)dGT.size(); i++)
-      for (int j = 0; j < (int)dGT.size(); j++)
-        TEST_R(tsm.distADM(i, j) < dGT[i][j] + 0.0001 && tsm.distADM(i, j)
-            > dGT[i][j] - 0.0001);
-  }
-  catch (...) {
+  TEST_GROUP_FUNCTION;
 
-    TEST_R(!"Shouldn't throw an error!");
-  }
+  tsg::ThreadPool &pool = tsg::ThreadPool::shared();
 
-  //test the top set motif discovery implementation
-  tsg::iseq motif;
+  TEST_R(tsg::ThreadPool::workers(3) == 3);
+  TEST_R(tsg::ThreadPool::workers(0) >= 1);
+  TEST_R(tsg::ThreadPool::workers(-1) == tsg::ThreadPool::workers(0));
 
+  //each block runs exactly once, also in repeated and nested jobs
+  for (int blocks = 1; blocks <= 6; blocks++) {
+
+    std::vector<std::atomic<int>> runs(blocks * 4);
+
+    pool.run(blocks, [&](const int block_in) {
+        runs[4 * block_in]++;
+
+        pool.run(3, [&](const int nested_in) {
+            runs[4 * block_in + 1 + nested_in]++;
+            });
+        });
+
+    bool flag = true;
+
+    for (auto &count : runs)
+      if (count != 1)
+        flag = false;
+
+    TEST_R(flag);
+  }
+
+  //the exceptions of the blocks are rethrown
   try {
 
-    TEST_R(tsm.tsm(motif, 20, 0.5) == 3);
-    TEST_R((int)motif.size() == 3);
-    TEST_R(tsm.tsm(motif, 20, 0.001) == 2);
-    TEST_R((int)motif.size() == 2);
-    TEST_R(tsm.tsm(motif, 20, 6.0) == 13);
-    TEST_R((int)motif.size() == 13);
-    for (int i = 0; i < (int)motif.size(); i++)
-      for (int j = 0; j < (int)motif.size(); j++)
-        if (i != j)
-          TEST_R(abs(motif[i] - motif[j]) >= 20);
+    pool.run(4, [](const int block_in) {
+        if (block_in == 2)
+          throw(EXIT_FAILURE);
+        });
+
+    TEST_R(!"Has to throw an error!");
   }
-  catch (...) {
+  catch (int e) {
 
-    TEST_R(!"Shouldn't throw an error!");
+    TEST_R(e == EXIT_FAILURE);
   }
+
+  //the pool is usable after an exception
+  std::atomic<int> sum(0);
+
+  pool.run(4, [&](const int block_in) { sum += block_in; });
+  TEST_R(sum == 6);
 }
 
 void test_tsgenerator() {
@@ -787,6 +2093,36 @@ void test_tsgenerator() {
         topMotifSetPos[1], 0.01);
     TEST_R(abs(similarity) <= 0.0000001);
 
+    //test the similarity with a visiting order
+    tsg::iseq order;
+    bool ordered = true;
+
+    for (int i = 0; i < 281; i += 11)
+      for (int j = 0; j < 281; j += 7)
+        if (abs(generator.testOrderedSimilarity(testTimeSeries, i, j,
+                std::numeric_limits<double>::max(), order)
+              - generator.testSimilarity(testTimeSeries, i, j,
+                std::numeric_limits<double>::max())) > 0.0000001)
+          ordered = false;
+
+    TEST_R(ordered);
+
+    generator.testOrderedSimilarity(testTimeSeries, topMotifSetPos[0],
+        topMotifSetPos[0], 0.0, order);
+
+    for (int i = 1; i < (int)order.size(); i++)
+      if (abs(testTimeSeries[topMotifSetPos[0] + order[i - 1]] - sums[
+            topMotifSetPos[0]] * rWindow) < abs(testTimeSeries[
+              topMotifSetPos[0] + order[i]] - sums[topMotifSetPos[0]]
+            * rWindow))
+        ordered = false;
+
+    TEST_R(ordered);
+
+    similarity = generator.testOrderedSimilarity(testTimeSeries,
+        topMotifSetPos[0], topMotifSetPos[2], 0.01, order);
+    TEST_R(similarity >= 0.01);
+
 
     //test calculate raw subsequence
     subsequence.clear();
@@ -802,6 +2138,207 @@ void test_tsgenerator() {
     TEST_R(subsequence[3] != subsequence[19]);
   }
 
+  {
+    //test the match generation
+    for (int window : { 37, 100 }) {
+
+      TestTSGenerator generator(1000, window, 1.0, 2.0, 4, 3, 10.0);
+      tsg::rseq motif(window);
+      tsg::rseq match;
+      tsg::rseqs matches;
+      tsg::rseq pair(2 * window);
+      tsg::rseq sums, sumSquares;
+      bool equal = true;
+      bool close = true;
+
+      for (int i = 0; i < window; i++)
+        motif[i] = 5.0 * sin(i * 0.2) + 0.3 * ((i * 7919) % 11);
+
+      generator.setSeed(5);
+      generator.testGenerateMatches(motif, 2.0, 6, matches);
+      TEST_R(matches.size() == 6);
+
+      //the batch draws the same matches as single calls and each match is
+      //within the range
+      generator.setSeed(5);
+
+      for (auto &batchMatch : matches) {
+
+        generator.testGenerateMatch(motif, 2.0, match);
+
+        if (match != batchMatch)
+          equal = false;
+      }
+
+      TEST_R(equal);
+
+      for (auto &batchMatch : matches) {
+
+        TEST_R((int)batchMatch.size() == window);
+
+        for (int i = 0; i < window; i++) {
+
+          pair[i] = motif[i];
+          pair[window + i] = batchMatch[i];
+        }
+
+        tsg::calcRunnings(pair, window, sums, sumSquares);
+
+        if (tsg::zNormEuclDist(pair, 0, window, window, sums, sumSquares,
+              std::numeric_limits<double>::max()) > 2.0)
+          close = false;
+      }
+
+      TEST_R(close);
+    }
+  }
+
+  {
+    //test the parallel larger motif set function
+    TestTSGenerator generator(1000, 20, 1.0, 2.0, 4, 3, 10.0, 1.0, 3, 5,
+        20.0, 0);
+    tsg::rseq ts(1000);
+    int serial;
+    bool flag = true;
+
+    for (int i = 0; i < 1000; i++)
+      ts[i] = sin(i * 0.1) + 0.1 * ((i * 7919) % 13);
+
+    generator.testCalcRunnings(ts);
+
+    for (int pos = 0; pos < 981; pos += 140)
+      for (int size = 1; size < 40; size += 9)
+        for (double range : {0.5, 2.0, 6.0}) {
+
+          generator.setThreads(1);
+          serial = generator.testLargerMotifSet(ts, pos, size, range);
+
+          for (int threads = 2; threads < 5; threads++) {
+
+            generator.setThreads(threads);
+
+            if (generator.testLargerMotifSet(ts, pos, size, range) != serial)
+              flag = false;
+          }
+        }
+
+    TEST_R(flag);
+  }
+
+  {
+    //test the reproducibility of the speculative placement
+    for (int gen = 0; gen < 3; gen++)
+      for (int speculation : {1, 4})
+        TEST_R(runTwice(gen, 42, [&](TestTSGenerator &generator_inout,
+                const int itr_in) {
+              generator_inout.setSpeculation(speculation);
+              generator_inout.setThreads(1 + 3 * itr_in); }));
+  }
+
+  {
+    //the pruning does not change the generated time series
+    double rates[2] = {0.0, 0.0};
+
+    TEST_R(runTwice(1, 7, [](TestTSGenerator &generator_inout, const int
+            itr_in) { generator_inout.setLowerBound(itr_in ? 4 : 0); },
+          [&](TestTSGenerator &generator_inout, const int itr_in, const
+            tsg::rseq &, const tsg::rseq &, const tsg::iseqs &) {
+          rates[itr_in] = generator_inout.getPruningRate(); }));
+    TEST_R(rates[0] == 0.0);
+    TEST_R(rates[1] > 0.0);
+  }
+
+  {
+    //the cache does not change the generated time series
+    long hits[2] = {0, 0};
+
+    TEST_R(runTwice(1, 7, [](TestTSGenerator &generator_inout, const int
+            itr_in) { generator_inout.setRowCache(itr_in
+              ? tsg::defaultRowCache : 0); },
+          [&](TestTSGenerator &generator_inout, const int itr_in, const
+            tsg::rseq &, const tsg::rseq &, const tsg::iseqs &) {
+          hits[itr_in] = generator_inout.getRowCacheHits(); }));
+    TEST_R(hits[0] == 0);
+    TEST_R(hits[1] > 0);
+  }
+
+  {
+    //test the certification of the ground truth
+    bool confirmed = true;
+
+    for (int gen = 0; gen < 3; gen++) {
+
+      tsg::certificate certs[2];
+
+      TEST_R(runTwice(gen, 7, [](TestTSGenerator &generator_inout, const int
+              itr_in) {
+            generator_inout.setThreads(1 + 3 * itr_in);
+            generator_inout.setCertification(true); },
+            [&](TestTSGenerator &generator_inout, const int itr_in, const
+              tsg::rseq &timeSeries_in, const tsg::rseq &d_in, const
+              tsg::iseqs &positions_in) {
+            certs[itr_in] = generator_inout.getCertificate();
+
+            //the certificate of an existing time series
+            double pruningRate = generator_inout.getPruningRate();
+            long misses = generator_inout.getRowCacheMisses();
+            tsg::certificate cert = generator_inout.certify(timeSeries_in,
+                d_in, positions_in);
+
+            if (cert.largest != certs[itr_in].largest || cert.runnerUp
+                != certs[itr_in].runnerUp || cert.center
+                != certs[itr_in].center)
+              confirmed = false;
+
+            //the certification does not change the state of the generator
+            if (generator_inout.getPruningRate() != pruningRate
+                || generator_inout.getRowCacheMisses() != misses)
+              confirmed = false;
+
+            //the winning set motif is not the claimed ground truth
+            tsg::iseqs others(positions_in);
+
+            others[0].clear();
+
+            for (int pos = 0; pos <= 1000 - 20 && others[0].size()
+                < positions_in[0].size(); pos += 20)
+              if (std::all_of(positions_in[0].begin(),
+                    positions_in[0].end(), [&](const int injected) {
+                    return pos != injected; }))
+                others[0].push_back(pos);
+
+            cert = generator_inout.certify(timeSeries_in, d_in, others);
+
+            if (cert.confirmed || std::find(others[0].begin(),
+                  others[0].end(), cert.center) != others[0].end())
+              confirmed = false;
+
+            //the certified set motif contains the injected one
+            if (!certs[itr_in].confirmed || certs[itr_in].largest != (gen
+                  ? (int)positions_in[0].size() : 2)
+                || certs[itr_in].margin < 1 || certs[itr_in].seconds < 0.0)
+              confirmed = false;
+
+            //no certificate without certification
+            tsg::rseq timeSeries;
+            tsg::rseqs motif;
+            tsg::rseq d;
+            tsg::iseqs positions;
+
+            generator_inout.setCertification(false);
+            generator_inout.run(timeSeries, motif, d, positions);
+
+            if (generator_inout.getCertificate().largest != 0)
+              confirmed = false; }));
+
+      TEST_R(certs[0].largest == certs[1].largest && certs[0].center
+          == certs[1].center && certs[0].runnerUp == certs[1].runnerUp
+          && certs[0].range == certs[1].range);
+    }
+
+    TEST_R(confirmed);
+  }
+
   {
     //test synthetic time series pair motif generation function
     TestTSGenerator simGenerator(1000, 20, 1.0, 2.0, 4, 3, 10.0, 1.0, 3, 5,
@@ -829,12 +2366,42 @@ void test_tsgenerator() {
 
         TEST_R(d_out.size() == 1);
         TEST_R(positions_out.size() == 1);
+        TEST_R(generator.getTopPairGap() >= 0.0);
+
+        //the gap is the one to the exact second pair motif
+        tsg::iseq pos0s;
+        tsg::iseq pos1s;
+        tsg::rseq ds;
+
+        tsg::tpmTopK(timeSeries_out, simGenerator.getSums(),
+            simGenerator.getSumSquares(), 20, 2, pos0s, pos1s, ds);
+
+        TEST_R(ds.size() == 2 && abs(generator.getTopPairGap() - ds[1]
+              + ds[0]) <= 0.000001);
       }
       catch (...) {
 
         TEST_R(!"Has to run without throwing an error!");
       }
     }
+
+    //test the pair motif generation with anytime estimates
+    generator.setBudget(0.0, 200);
+
+    try {
+
+      generator.run(timeSeries_out, motif, d_out, positions_out);
+      TEST_R("Has to run without throwing an error!");
+
+      simGenerator.testCalcRunnings(timeSeries_out);
+      d = simGenerator.testSimilarity(timeSeries_out, positions_out[0][0],
+            positions_out[0][1], d_out[0]);
+      TEST_R(d <= d_out[0] + 0.0000001 && d >= d_out[0] - 0.0000001);
+    }
+    catch (...) {
+
+      TEST_R(!"Has to run without throwing an error!");
+    }
   }
 
   {
@@ -927,6 +2494,24 @@ int main() {
     test_basets();
     TEST_SECTION("top set motif");
     test_tsm();
+    TEST_SECTION("top pair motif");
+    test_tpm();
+    TEST_SECTION("matrix profile");
+    test_matrixprofile();
+    TEST_SECTION("running statistics");
+    test_runningstats();
+    TEST_SECTION("prefix statistics");
+    test_prefixstats();
+    TEST_SECTION("subsequence statistics");
+    test_subsequencestats();
+    TEST_SECTION("distance profile");
+    test_distanceprofile();
+    TEST_SECTION("distance kernel");
+    test_distancekernel();
+    TEST_SECTION("distance row cache");
+    test_distancerowcache();
+    TEST_SECTION("thread pool");
+    test_threadpool();
     TEST_SECTION("time series generator");
     test_tsgenerator();
 
@@ -12,11 +12,20 @@
 #include <stest.hpp>
 #include <tsgenerator.hpp>
 #include <freepositions.hpp>
+#include <matrixprofile.hpp>
+#include <runningstats.hpp>
+#include <prefixstats.hpp>
+#include <distanceprofile.hpp>
+#include <distancerowcache.hpp>
+#include <distancekernel.hpp>
+#include <threadpool.hpp>
 #include <basets.hpp>
 #include <tsm.hpp>
+#include <tsgutils.hpp>
 #include <iostream>
 #include <sstream>
 #include <filesystem>
+#include <functional>
 
 
 // --------------------------------------------------------------------------
@@ -1558,6 +1567,87 @@ public:
         subsequenceTwoPos_in, bestSoFar_in);
   }
 
+  // --------------------------------------------------------------------------
+  ///\brief Runs the similarity function with a visiting order.
+  ///
+  ///\param [in] &timeSeries_in Hands over the time series.
+  ///\param [in] pos0_in Hands over the position of the fixed subsequence.
+  ///\param [in] pos1_in Hands over the position of the second subsequence.
+  ///\param [in] bestSoFar_in Hands over the best similarity so far.
+  ///\param [out] &order_out Returns the visiting order of the fixed
+  ///subsequence.
+  ///
+  ///\return The similarity of the two z-normalized subsequences.
+  ///
+  ///This function runs the visiting order and the similarity function since
+  ///both functions are protected.
+  // --------------------------------------------------------------------------
+  double testOrderedSimilarity(const tsg::rseq &timeSeries_in, const int
+      pos0_in, const int pos1_in, const double bestSoFar_in, tsg::iseq
+      &order_out) {
+
+    tsg::rseq zSequence;
+
+    visitingOrder(timeSeries_in, stats, pos0_in, zSequence, order_out);
+
+    return similarity(timeSeries_in, stats, zSequence, order_out, pos1_in,
+        bestSoFar_in);
+  }
+
+  // --------------------------------------------------------------------------
+  ///\brief Runs the generate match function.
+  ///
+  ///\param [in] &motif_in Hands over the motif.
+  ///\param [in] range_in Hands over the motif range.
+  ///\param [out] &match_out Returns the match.
+  ///
+  ///This function stores the motif and runs the generate match function since
+  ///both functions are protected.
+  // --------------------------------------------------------------------------
+  void testGenerateMatch(const tsg::rseq &motif_in, const double range_in,
+      tsg::rseq &match_out) {
+
+    mzNormMotif(motif_in);
+    generateMatch(range_in, match_out);
+  }
+
+  // --------------------------------------------------------------------------
+  ///\brief Runs the generate matches function.
+  ///
+  ///\param [in] &motif_in Hands over the motif.
+  ///\param [in] range_in Hands over the motif range.
+  ///\param [in] count_in Hands over the number of matches.
+  ///\param [out] &matches_out Returns the matches.
+  ///
+  ///This function stores the motif and runs the generate matches function
+  ///since both functions are protected.
+  // --------------------------------------------------------------------------
+  void testGenerateMatches(const tsg::rseq &motif_in, const double range_in,
+      const int count_in, tsg::rseqs &matches_out) {
+
+    mzNormMotif(motif_in);
+    generateMatches(range_in, count_in, matches_out);
+  }
+
+  // --------------------------------------------------------------------------
+  ///\brief Runs the larger motif set function.
+  ///
+  ///\param [in] &timeSeries_in Hands over the time series.
+  ///\param [in] pos_in Hands over the position of the subsequence.
+  ///\param [in] size_in Hands over the size of the injected motif.
+  ///\param [in] range_in Hands over the motif set range.
+  ///
+  ///\return The size of the largest set motif.
+  ///
+  ///This function runs the larger motif set function since the larger motif
+  ///set function is protected.
+  // --------------------------------------------------------------------------
+  int testLargerMotifSet(const tsg::rseq &timeSeries_in, const int pos_in,
+      const int size_in, const double range_in) {
+
+    return largerMotifSet(timeSeries_in, pos_in, size_in, range_in);
+  }
+
   // --------------------------------------------------------------------------
   ///\brief Runs the mean and standard deviation function.
   ///
@@ -1659,4 +1749,56 @@ public:
   }
 };
 
+// --------------------------------------------------------------------------
+///\brief Runs two generators that differ in their settings.
+///
+///\param [in] gen_in Hands over the motif generator.
+///\param [in] seed_in Hands over the seed of both generators.
+///\param [in] &setup_in Hands over the function that changes the settings of
+///the generator of the given run.
+///\param [in] &check_in Hands over the function that checks the generator and
+///the time series, ranges and positions of the given run.
+///
+///\return True if neither run threw an error and both runs generated the same
+///time series, ranges and positions, false otherwise.
+///
+///This function runs the end-to-end checks of settings that must not change
+///the generated time series, e.g., threads, pruning and caches, on 1000 values
+///with window size 20.
+// --------------------------------------------------------------------------
+bool runTwice(const int gen_in, const int seed_in, const
+    std::function<void(TestTSGenerator &, const int)> &setup_in, const
+    std::function<void(TestTSGenerator &, const int, const tsg::rseq &, const
+      tsg::rseq &, const tsg::iseqs &)> &check_in = nullptr) {
+
+  tsg::rseqs timeSeries(2);
+  tsg::rseqs d(2);
+  std::vector<tsg::iseqs> positions(2);
+
+  for (int itr = 0; itr < 2; itr++) {
+
+    TestTSGenerator generator(1000, 20, 1.0, 2.0, 4, 3, 10.0, 1.0, 3, 5,
+        20.0, gen_in);
+    tsg::rseqs motif;
+
+    generator.setSeed(seed_in);
+    setup_in(generator, itr);
+
+    try {
+
+      generator.run(timeSeries[itr], motif, d[itr], positions[itr]);
+
+      if (check_in)
+        check_in(generator, itr, timeSeries[itr], d[itr], positions[itr]);
+    }
+    catch (int e) {
+
+      return false;
+    }
+  }
+
+  return timeSeries[0] == timeSeries[1] && d[0] == d[1] && positions[0]
+    == positions[1];
+}
+
 #endif